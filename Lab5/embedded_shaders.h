@@ -0,0 +1,160 @@
+//
+//  embedded_shaders.h
+//  Outline Drawing
+//
+//  Generated by tools/embed_shaders.cpp from: polyline.vs polyline.fs
+//  Do not edit; regenerate after changing a shader.
+//
+
+#ifndef EMBEDDED_SHADERS_H
+#define EMBEDDED_SHADERS_H
+
+#include <cstddef>
+
+constexpr char embedded_polyline_vs[1995] = {
+    '\x23', '\x76', '\x65', '\x72', '\x73', '\x69', '\x6f', '\x6e', '\x20', '\x33', '\x33', '\x30', '\x20', '\x63', '\x6f', '\x72',
+    '\x65', '\x0a', '\x6c', '\x61', '\x79', '\x6f', '\x75', '\x74', '\x20', '\x28', '\x6c', '\x6f', '\x63', '\x61', '\x74', '\x69',
+    '\x6f', '\x6e', '\x20', '\x3d', '\x20', '\x30', '\x29', '\x20', '\x69', '\x6e', '\x20', '\x75', '\x69', '\x6e', '\x74', '\x20',
+    '\x61', '\x50', '\x72', '\x65', '\x76', '\x69', '\x6f', '\x75', '\x73', '\x3b', '\x0a', '\x6c', '\x61', '\x79', '\x6f', '\x75',
+    '\x74', '\x20', '\x28', '\x6c', '\x6f', '\x63', '\x61', '\x74', '\x69', '\x6f', '\x6e', '\x20', '\x3d', '\x20', '\x31', '\x29',
+    '\x20', '\x69', '\x6e', '\x20', '\x75', '\x69', '\x6e', '\x74', '\x20', '\x61', '\x53', '\x74', '\x61', '\x72', '\x74', '\x3b',
+    '\x0a', '\x6c', '\x61', '\x79', '\x6f', '\x75', '\x74', '\x20', '\x28', '\x6c', '\x6f', '\x63', '\x61', '\x74', '\x69', '\x6f',
+    '\x6e', '\x20', '\x3d', '\x20', '\x32', '\x29', '\x20', '\x69', '\x6e', '\x20', '\x75', '\x69', '\x6e', '\x74', '\x20', '\x61',
+    '\x45', '\x6e', '\x64', '\x3b', '\x0a', '\x6c', '\x61', '\x79', '\x6f', '\x75', '\x74', '\x20', '\x28', '\x6c', '\x6f', '\x63',
+    '\x61', '\x74', '\x69', '\x6f', '\x6e', '\x20', '\x3d', '\x20', '\x33', '\x29', '\x20', '\x69', '\x6e', '\x20', '\x75', '\x69',
+    '\x6e', '\x74', '\x20', '\x61', '\x4e', '\x65', '\x78', '\x74', '\x3b', '\x0a', '\x0a', '\x2f', '\x2f', '\x20', '\x74', '\x68',
+    '\x69', '\x63', '\x6b', '\x20', '\x70', '\x6f', '\x6c', '\x79', '\x6c', '\x69', '\x6e', '\x65', '\x20', '\x73', '\x65', '\x67',
+    '\x6d', '\x65', '\x6e', '\x74', '\x73', '\x2c', '\x20', '\x6f', '\x6e', '\x65', '\x20', '\x69', '\x6e', '\x73', '\x74', '\x61',
+    '\x6e', '\x63', '\x65', '\x20', '\x65', '\x61', '\x63', '\x68', '\x20', '\x28', '\x73', '\x65', '\x65', '\x20', '\x70', '\x6f',
+    '\x6c', '\x79', '\x6c', '\x69', '\x6e', '\x65', '\x5f', '\x72', '\x65', '\x6e', '\x64', '\x65', '\x72', '\x65', '\x72', '\x2e',
+    '\x68', '\x29', '\x0a', '\x75', '\x6e', '\x69', '\x66', '\x6f', '\x72', '\x6d', '\x20', '\x73', '\x61', '\x6d', '\x70', '\x6c',
+    '\x65', '\x72', '\x42', '\x75', '\x66', '\x66', '\x65', '\x72', '\x20', '\x70', '\x6f', '\x69', '\x6e', '\x74', '\x73', '\x3b',
+    '\x20', '\x20', '\x20', '\x2f', '\x2f', '\x20', '\x78', '\x2c', '\x20', '\x79', '\x2c', '\x20', '\x77', '\x69', '\x64', '\x74',
+    '\x68', '\x0a', '\x75', '\x6e', '\x69', '\x66', '\x6f', '\x72', '\x6d', '\x20', '\x76', '\x65', '\x63', '\x34', '\x20', '\x74',
+    '\x72', '\x61', '\x6e', '\x73', '\x66', '\x6f', '\x72', '\x6d', '\x3b', '\x20', '\x20', '\x20', '\x20', '\x20', '\x20', '\x20',
+    '\x20', '\x20', '\x2f', '\x2f', '\x20', '\x78', '\x79', '\x20', '\x73', '\x63', '\x61', '\x6c', '\x65', '\x2c', '\x20', '\x7a',
+    '\x77', '\x20', '\x6f', '\x66', '\x66', '\x73', '\x65', '\x74', '\x0a', '\x75', '\x6e', '\x69', '\x66', '\x6f', '\x72', '\x6d',
+    '\x20', '\x76', '\x65', '\x63', '\x32', '\x20', '\x76', '\x69', '\x65', '\x77', '\x70', '\x6f', '\x72', '\x74', '\x3b', '\x0a',
+    '\x75', '\x6e', '\x69', '\x66', '\x6f', '\x72', '\x6d', '\x20', '\x66', '\x6c', '\x6f', '\x61', '\x74', '\x20', '\x6d', '\x69',
+    '\x74', '\x65', '\x72', '\x4c', '\x69', '\x6d', '\x69', '\x74', '\x3b', '\x0a', '\x75', '\x6e', '\x69', '\x66', '\x6f', '\x72',
+    '\x6d', '\x20', '\x66', '\x6c', '\x6f', '\x61', '\x74', '\x20', '\x63', '\x61', '\x70', '\x45', '\x78', '\x74', '\x65', '\x6e',
+    '\x73', '\x69', '\x6f', '\x6e', '\x3b', '\x0a', '\x0a', '\x76', '\x65', '\x63', '\x34', '\x20', '\x66', '\x65', '\x74', '\x63',
+    '\x68', '\x28', '\x75', '\x69', '\x6e', '\x74', '\x20', '\x65', '\x6e', '\x74', '\x72', '\x79', '\x29', '\x0a', '\x7b', '\x0a',
+    '\x20', '\x20', '\x20', '\x72', '\x65', '\x74', '\x75', '\x72', '\x6e', '\x20', '\x74', '\x65', '\x78', '\x65', '\x6c', '\x46',
+    '\x65', '\x74', '\x63', '\x68', '\x28', '\x70', '\x6f', '\x69', '\x6e', '\x74', '\x73', '\x2c', '\x20', '\x69', '\x6e', '\x74',
+    '\x28', '\x65', '\x6e', '\x74', '\x72', '\x79', '\x20', '\x26', '\x20', '\x30', '\x78', '\x37', '\x46', '\x46', '\x46', '\x46',
+    '\x46', '\x46', '\x46', '\x75', '\x29', '\x29', '\x3b', '\x0a', '\x7d', '\x0a', '\x0a', '\x76', '\x65', '\x63', '\x32', '\x20',
+    '\x74', '\x6f', '\x50', '\x69', '\x78', '\x65', '\x6c', '\x73', '\x28', '\x75', '\x69', '\x6e', '\x74', '\x20', '\x65', '\x6e',
+    '\x74', '\x72', '\x79', '\x29', '\x0a', '\x7b', '\x0a', '\x20', '\x20', '\x20', '\x72', '\x65', '\x74', '\x75', '\x72', '\x6e',
+    '\x20', '\x28', '\x66', '\x65', '\x74', '\x63', '\x68', '\x28', '\x65', '\x6e', '\x74', '\x72', '\x79', '\x29', '\x2e', '\x78',
+    '\x79', '\x20', '\x2a', '\x20', '\x74', '\x72', '\x61', '\x6e', '\x73', '\x66', '\x6f', '\x72', '\x6d', '\x2e', '\x78', '\x79',
+    '\x20', '\x2b', '\x20', '\x74', '\x72', '\x61', '\x6e', '\x73', '\x66', '\x6f', '\x72', '\x6d', '\x2e', '\x7a', '\x77', '\x29',
+    '\x20', '\x2a', '\x20', '\x30', '\x2e', '\x35', '\x20', '\x2a', '\x20', '\x76', '\x69', '\x65', '\x77', '\x70', '\x6f', '\x72',
+    '\x74', '\x3b', '\x0a', '\x7d', '\x0a', '\x0a', '\x76', '\x6f', '\x69', '\x64', '\x20', '\x6d', '\x61', '\x69', '\x6e', '\x28',
+    '\x29', '\x0a', '\x7b', '\x0a', '\x20', '\x20', '\x20', '\x76', '\x65', '\x63', '\x32', '\x20', '\x73', '\x74', '\x61', '\x72',
+    '\x74', '\x20', '\x3d', '\x20', '\x74', '\x6f', '\x50', '\x69', '\x78', '\x65', '\x6c', '\x73', '\x28', '\x61', '\x53', '\x74',
+    '\x61', '\x72', '\x74', '\x29', '\x3b', '\x0a', '\x20', '\x20', '\x20', '\x76', '\x65', '\x63', '\x32', '\x20', '\x65', '\x6e',
+    '\x64', '\x20', '\x3d', '\x20', '\x74', '\x6f', '\x50', '\x69', '\x78', '\x65', '\x6c', '\x73', '\x28', '\x61', '\x45', '\x6e',
+    '\x64', '\x29', '\x3b', '\x0a', '\x20', '\x20', '\x20', '\x2f', '\x2f', '\x20', '\x73', '\x65', '\x67', '\x6d', '\x65', '\x6e',
+    '\x74', '\x73', '\x20', '\x62', '\x65', '\x74', '\x77', '\x65', '\x65', '\x6e', '\x20', '\x74', '\x77', '\x6f', '\x20', '\x70',
+    '\x6f', '\x6c', '\x79', '\x6c', '\x69', '\x6e', '\x65', '\x73', '\x20', '\x28', '\x61', '\x6e', '\x64', '\x20', '\x70', '\x6f',
+    '\x69', '\x6e', '\x74', '\x73', '\x20', '\x74', '\x68', '\x61', '\x74', '\x20', '\x63', '\x6f', '\x69', '\x6e', '\x63', '\x69',
+    '\x64', '\x65', '\x20', '\x6f', '\x6e', '\x20', '\x73', '\x63', '\x72', '\x65', '\x65', '\x6e', '\x29', '\x20', '\x61', '\x72',
+    '\x65', '\x20', '\x63', '\x6f', '\x6c', '\x6c', '\x61', '\x70', '\x73', '\x65', '\x64', '\x0a', '\x20', '\x20', '\x20', '\x69',
+    '\x66', '\x20', '\x28', '\x28', '\x61', '\x53', '\x74', '\x61', '\x72', '\x74', '\x20', '\x26', '\x20', '\x30', '\x78', '\x38',
+    '\x30', '\x30', '\x30', '\x30', '\x30', '\x30', '\x30', '\x75', '\x29', '\x20', '\x3d', '\x3d', '\x20', '\x30', '\x75', '\x20',
+    '\x7c', '\x7c', '\x20', '\x64', '\x69', '\x73', '\x74', '\x61', '\x6e', '\x63', '\x65', '\x28', '\x73', '\x74', '\x61', '\x72',
+    '\x74', '\x2c', '\x20', '\x65', '\x6e', '\x64', '\x29', '\x20', '\x3c', '\x20', '\x31', '\x65', '\x2d', '\x34', '\x29', '\x0a',
+    '\x20', '\x20', '\x20', '\x7b', '\x0a', '\x20', '\x20', '\x20', '\x20', '\x20', '\x20', '\x20', '\x67', '\x6c', '\x5f', '\x50',
+    '\x6f', '\x73', '\x69', '\x74', '\x69', '\x6f', '\x6e', '\x20', '\x3d', '\x20', '\x76', '\x65', '\x63', '\x34', '\x28', '\x30',
+    '\x2e', '\x30', '\x2c', '\x20', '\x30', '\x2e', '\x30', '\x2c', '\x20', '\x30', '\x2e', '\x30', '\x2c', '\x20', '\x31', '\x2e',
+    '\x30', '\x29', '\x3b', '\x0a', '\x20', '\x20', '\x20', '\x20', '\x20', '\x20', '\x20', '\x72', '\x65', '\x74', '\x75', '\x72',
+    '\x6e', '\x3b', '\x0a', '\x20', '\x20', '\x20', '\x7d', '\x0a', '\x20', '\x20', '\x20', '\x62', '\x6f', '\x6f', '\x6c', '\x20',
+    '\x61', '\x74', '\x45', '\x6e', '\x64', '\x20', '\x3d', '\x20', '\x67', '\x6c', '\x5f', '\x56', '\x65', '\x72', '\x74', '\x65',
+    '\x78', '\x49', '\x44', '\x20', '\x3e', '\x3d', '\x20', '\x32', '\x3b', '\x0a', '\x20', '\x20', '\x20', '\x66', '\x6c', '\x6f',
+    '\x61', '\x74', '\x20', '\x73', '\x69', '\x64', '\x65', '\x20', '\x3d', '\x20', '\x67', '\x6c', '\x5f', '\x56', '\x65', '\x72',
+    '\x74', '\x65', '\x78', '\x49', '\x44', '\x20', '\x25', '\x20', '\x32', '\x20', '\x3d', '\x3d', '\x20', '\x30', '\x20', '\x3f',
+    '\x20', '\x2d', '\x31', '\x2e', '\x30', '\x20', '\x3a', '\x20', '\x31', '\x2e', '\x30', '\x3b', '\x0a', '\x20', '\x20', '\x20',
+    '\x66', '\x6c', '\x6f', '\x61', '\x74', '\x20', '\x68', '\x61', '\x6c', '\x66', '\x57', '\x69', '\x64', '\x74', '\x68', '\x20',
+    '\x3d', '\x20', '\x30', '\x2e', '\x35', '\x20', '\x2a', '\x20', '\x66', '\x65', '\x74', '\x63', '\x68', '\x28', '\x61', '\x53',
+    '\x74', '\x61', '\x72', '\x74', '\x29', '\x2e', '\x7a', '\x3b', '\x0a', '\x20', '\x20', '\x20', '\x76', '\x65', '\x63', '\x32',
+    '\x20', '\x64', '\x69', '\x72', '\x65', '\x63', '\x74', '\x69', '\x6f', '\x6e', '\x20', '\x3d', '\x20', '\x6e', '\x6f', '\x72',
+    '\x6d', '\x61', '\x6c', '\x69', '\x7a', '\x65', '\x28', '\x65', '\x6e', '\x64', '\x20', '\x2d', '\x20', '\x73', '\x74', '\x61',
+    '\x72', '\x74', '\x29', '\x3b', '\x0a', '\x20', '\x20', '\x20', '\x76', '\x65', '\x63', '\x32', '\x20', '\x6e', '\x6f', '\x72',
+    '\x6d', '\x61', '\x6c', '\x20', '\x3d', '\x20', '\x76', '\x65', '\x63', '\x32', '\x28', '\x2d', '\x64', '\x69', '\x72', '\x65',
+    '\x63', '\x74', '\x69', '\x6f', '\x6e', '\x2e', '\x79', '\x2c', '\x20', '\x64', '\x69', '\x72', '\x65', '\x63', '\x74', '\x69',
+    '\x6f', '\x6e', '\x2e', '\x78', '\x29', '\x3b', '\x0a', '\x20', '\x20', '\x20', '\x76', '\x65', '\x63', '\x32', '\x20', '\x70',
+    '\x6f', '\x69', '\x6e', '\x74', '\x20', '\x3d', '\x20', '\x61', '\x74', '\x45', '\x6e', '\x64', '\x20', '\x3f', '\x20', '\x65',
+    '\x6e', '\x64', '\x20', '\x3a', '\x20', '\x73', '\x74', '\x61', '\x72', '\x74', '\x3b', '\x0a', '\x20', '\x20', '\x20', '\x76',
+    '\x65', '\x63', '\x32', '\x20', '\x6e', '\x65', '\x69', '\x67', '\x68', '\x62', '\x6f', '\x75', '\x72', '\x20', '\x3d', '\x20',
+    '\x61', '\x74', '\x45', '\x6e', '\x64', '\x20', '\x3f', '\x20', '\x74', '\x6f', '\x50', '\x69', '\x78', '\x65', '\x6c', '\x73',
+    '\x28', '\x61', '\x4e', '\x65', '\x78', '\x74', '\x29', '\x20', '\x3a', '\x20', '\x74', '\x6f', '\x50', '\x69', '\x78', '\x65',
+    '\x6c', '\x73', '\x28', '\x61', '\x50', '\x72', '\x65', '\x76', '\x69', '\x6f', '\x75', '\x73', '\x29', '\x3b', '\x0a', '\x20',
+    '\x20', '\x20', '\x76', '\x65', '\x63', '\x32', '\x20', '\x6f', '\x66', '\x66', '\x73', '\x65', '\x74', '\x3b', '\x0a', '\x20',
+    '\x20', '\x20', '\x69', '\x66', '\x20', '\x28', '\x64', '\x69', '\x73', '\x74', '\x61', '\x6e', '\x63', '\x65', '\x28', '\x6e',
+    '\x65', '\x69', '\x67', '\x68', '\x62', '\x6f', '\x75', '\x72', '\x2c', '\x20', '\x70', '\x6f', '\x69', '\x6e', '\x74', '\x29',
+    '\x20', '\x3c', '\x20', '\x31', '\x65', '\x2d', '\x34', '\x29', '\x0a', '\x20', '\x20', '\x20', '\x7b', '\x0a', '\x20', '\x20',
+    '\x20', '\x20', '\x20', '\x20', '\x20', '\x2f', '\x2f', '\x20', '\x6f', '\x70', '\x65', '\x6e', '\x20', '\x65', '\x6e', '\x64',
+    '\x3a', '\x20', '\x62', '\x75', '\x74', '\x74', '\x20', '\x63', '\x61', '\x70', '\x2c', '\x20', '\x70', '\x75', '\x73', '\x68',
+    '\x65', '\x64', '\x20', '\x6f', '\x75', '\x74', '\x20', '\x62', '\x79', '\x20', '\x63', '\x61', '\x70', '\x45', '\x78', '\x74',
+    '\x65', '\x6e', '\x73', '\x69', '\x6f', '\x6e', '\x20', '\x68', '\x61', '\x6c', '\x66', '\x20', '\x77', '\x69', '\x64', '\x74',
+    '\x68', '\x73', '\x0a', '\x20', '\x20', '\x20', '\x20', '\x20', '\x20', '\x20', '\x6f', '\x66', '\x66', '\x73', '\x65', '\x74',
+    '\x20', '\x3d', '\x20', '\x6e', '\x6f', '\x72', '\x6d', '\x61', '\x6c', '\x20', '\x2a', '\x20', '\x68', '\x61', '\x6c', '\x66',
+    '\x57', '\x69', '\x64', '\x74', '\x68', '\x20', '\x2a', '\x20', '\x73', '\x69', '\x64', '\x65', '\x20', '\x2b', '\x20', '\x64',
+    '\x69', '\x72', '\x65', '\x63', '\x74', '\x69', '\x6f', '\x6e', '\x20', '\x2a', '\x20', '\x68', '\x61', '\x6c', '\x66', '\x57',
+    '\x69', '\x64', '\x74', '\x68', '\x20', '\x2a', '\x20', '\x63', '\x61', '\x70', '\x45', '\x78', '\x74', '\x65', '\x6e', '\x73',
+    '\x69', '\x6f', '\x6e', '\x20', '\x2a', '\x20', '\x28', '\x61', '\x74', '\x45', '\x6e', '\x64', '\x20', '\x3f', '\x20', '\x31',
+    '\x2e', '\x30', '\x20', '\x3a', '\x20', '\x2d', '\x31', '\x2e', '\x30', '\x29', '\x3b', '\x0a', '\x20', '\x20', '\x20', '\x7d',
+    '\x0a', '\x20', '\x20', '\x20', '\x65', '\x6c', '\x73', '\x65', '\x0a', '\x20', '\x20', '\x20', '\x7b', '\x0a', '\x20', '\x20',
+    '\x20', '\x20', '\x20', '\x20', '\x20', '\x2f', '\x2f', '\x20', '\x6a', '\x6f', '\x69', '\x6e', '\x3a', '\x20', '\x62', '\x6f',
+    '\x74', '\x68', '\x20', '\x73', '\x65', '\x67', '\x6d', '\x65', '\x6e', '\x74', '\x73', '\x20', '\x6d', '\x6f', '\x76', '\x65',
+    '\x20', '\x74', '\x68', '\x65', '\x69', '\x72', '\x20', '\x73', '\x68', '\x61', '\x72', '\x65', '\x64', '\x20', '\x63', '\x6f',
+    '\x72', '\x6e', '\x65', '\x72', '\x20', '\x74', '\x6f', '\x20', '\x74', '\x68', '\x65', '\x20', '\x73', '\x61', '\x6d', '\x65',
+    '\x20', '\x6d', '\x69', '\x74', '\x65', '\x72', '\x20', '\x70', '\x6f', '\x69', '\x6e', '\x74', '\x0a', '\x20', '\x20', '\x20',
+    '\x20', '\x20', '\x20', '\x20', '\x76', '\x65', '\x63', '\x32', '\x20', '\x6f', '\x74', '\x68', '\x65', '\x72', '\x20', '\x3d',
+    '\x20', '\x61', '\x74', '\x45', '\x6e', '\x64', '\x20', '\x3f', '\x20', '\x6e', '\x6f', '\x72', '\x6d', '\x61', '\x6c', '\x69',
+    '\x7a', '\x65', '\x28', '\x6e', '\x65', '\x69', '\x67', '\x68', '\x62', '\x6f', '\x75', '\x72', '\x20', '\x2d', '\x20', '\x65',
+    '\x6e', '\x64', '\x29', '\x20', '\x3a', '\x20', '\x6e', '\x6f', '\x72', '\x6d', '\x61', '\x6c', '\x69', '\x7a', '\x65', '\x28',
+    '\x73', '\x74', '\x61', '\x72', '\x74', '\x20', '\x2d', '\x20', '\x6e', '\x65', '\x69', '\x67', '\x68', '\x62', '\x6f', '\x75',
+    '\x72', '\x29', '\x3b', '\x0a', '\x20', '\x20', '\x20', '\x20', '\x20', '\x20', '\x20', '\x76', '\x65', '\x63', '\x32', '\x20',
+    '\x74', '\x61', '\x6e', '\x67', '\x65', '\x6e', '\x74', '\x20', '\x3d', '\x20', '\x64', '\x69', '\x72', '\x65', '\x63', '\x74',
+    '\x69', '\x6f', '\x6e', '\x20', '\x2b', '\x20', '\x6f', '\x74', '\x68', '\x65', '\x72', '\x3b', '\x0a', '\x20', '\x20', '\x20',
+    '\x20', '\x20', '\x20', '\x20', '\x74', '\x61', '\x6e', '\x67', '\x65', '\x6e', '\x74', '\x20', '\x3d', '\x20', '\x6c', '\x65',
+    '\x6e', '\x67', '\x74', '\x68', '\x28', '\x74', '\x61', '\x6e', '\x67', '\x65', '\x6e', '\x74', '\x29', '\x20', '\x3c', '\x20',
+    '\x31', '\x65', '\x2d', '\x34', '\x20', '\x3f', '\x20', '\x64', '\x69', '\x72', '\x65', '\x63', '\x74', '\x69', '\x6f', '\x6e',
+    '\x20', '\x3a', '\x20', '\x6e', '\x6f', '\x72', '\x6d', '\x61', '\x6c', '\x69', '\x7a', '\x65', '\x28', '\x74', '\x61', '\x6e',
+    '\x67', '\x65', '\x6e', '\x74', '\x29', '\x3b', '\x0a', '\x20', '\x20', '\x20', '\x20', '\x20', '\x20', '\x20', '\x76', '\x65',
+    '\x63', '\x32', '\x20', '\x6d', '\x69', '\x74', '\x65', '\x72', '\x20', '\x3d', '\x20', '\x76', '\x65', '\x63', '\x32', '\x28',
+    '\x2d', '\x74', '\x61', '\x6e', '\x67', '\x65', '\x6e', '\x74', '\x2e', '\x79', '\x2c', '\x20', '\x74', '\x61', '\x6e', '\x67',
+    '\x65', '\x6e', '\x74', '\x2e', '\x78', '\x29', '\x3b', '\x0a', '\x20', '\x20', '\x20', '\x20', '\x20', '\x20', '\x20', '\x6f',
+    '\x66', '\x66', '\x73', '\x65', '\x74', '\x20', '\x3d', '\x20', '\x6d', '\x69', '\x74', '\x65', '\x72', '\x20', '\x2a', '\x20',
+    '\x73', '\x69', '\x64', '\x65', '\x20', '\x2a', '\x20', '\x68', '\x61', '\x6c', '\x66', '\x57', '\x69', '\x64', '\x74', '\x68',
+    '\x20', '\x2f', '\x20', '\x6d', '\x61', '\x78', '\x28', '\x64', '\x6f', '\x74', '\x28', '\x6d', '\x69', '\x74', '\x65', '\x72',
+    '\x2c', '\x20', '\x6e', '\x6f', '\x72', '\x6d', '\x61', '\x6c', '\x29', '\x2c', '\x20', '\x31', '\x2e', '\x30', '\x20', '\x2f',
+    '\x20', '\x6d', '\x69', '\x74', '\x65', '\x72', '\x4c', '\x69', '\x6d', '\x69', '\x74', '\x29', '\x3b', '\x0a', '\x20', '\x20',
+    '\x20', '\x7d', '\x0a', '\x20', '\x20', '\x20', '\x67', '\x6c', '\x5f', '\x50', '\x6f', '\x73', '\x69', '\x74', '\x69', '\x6f',
+    '\x6e', '\x20', '\x3d', '\x20', '\x76', '\x65', '\x63', '\x34', '\x28', '\x28', '\x70', '\x6f', '\x69', '\x6e', '\x74', '\x20',
+    '\x2b', '\x20', '\x6f', '\x66', '\x66', '\x73', '\x65', '\x74', '\x29', '\x20', '\x2f', '\x20', '\x28', '\x30', '\x2e', '\x35',
+    '\x20', '\x2a', '\x20', '\x76', '\x69', '\x65', '\x77', '\x70', '\x6f', '\x72', '\x74', '\x29', '\x2c', '\x20', '\x30', '\x2e',
+    '\x30', '\x2c', '\x20', '\x31', '\x2e', '\x30', '\x29', '\x3b', '\x0a', '\x7d', '\x0a',
+};
+constexpr size_t embedded_polyline_vs_size = 1995;
+
+constexpr char embedded_polyline_fs[98] = {
+    '\x23', '\x76', '\x65', '\x72', '\x73', '\x69', '\x6f', '\x6e', '\x20', '\x33', '\x33', '\x30', '\x20', '\x63', '\x6f', '\x72',
+    '\x65', '\x0a', '\x6f', '\x75', '\x74', '\x20', '\x76', '\x65', '\x63', '\x34', '\x20', '\x46', '\x72', '\x61', '\x67', '\x43',
+    '\x6f', '\x6c', '\x6f', '\x72', '\x3b', '\x0a', '\x0a', '\x75', '\x6e', '\x69', '\x66', '\x6f', '\x72', '\x6d', '\x20', '\x76',
+    '\x65', '\x63', '\x34', '\x20', '\x63', '\x6f', '\x6c', '\x6f', '\x72', '\x3b', '\x0a', '\x0a', '\x76', '\x6f', '\x69', '\x64',
+    '\x20', '\x6d', '\x61', '\x69', '\x6e', '\x28', '\x29', '\x0a', '\x7b', '\x0a', '\x20', '\x20', '\x20', '\x46', '\x72', '\x61',
+    '\x67', '\x43', '\x6f', '\x6c', '\x6f', '\x72', '\x20', '\x3d', '\x20', '\x63', '\x6f', '\x6c', '\x6f', '\x72', '\x3b', '\x0a',
+    '\x7d', '\x0a',
+};
+constexpr size_t embedded_polyline_fs_size = 98;
+
+static const EmbeddedShader embeddedShaders[] = {
+    { "polyline.vs", embedded_polyline_vs, embedded_polyline_vs_size },
+    { "polyline.fs", embedded_polyline_fs, embedded_polyline_fs_size },
+};
+static const size_t embeddedShaderCount = 2;
+
+#endif
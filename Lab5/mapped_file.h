@@ -0,0 +1,105 @@
+//
+//  mapped_file.h
+//  Outline Drawing
+//
+//  Read-only memory mapping of a whole file (mmap / MapViewOfFile), for data
+//  that is used in place instead of being read into a buffer: shader sources
+//  and binary meshes.
+//
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// read-only mapping of a whole file; data() stays valid for the lifetime of the object
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& path) : bytes(nullptr), length(0), valid(false)
+    {
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        mapping = NULL;
+        if (file == INVALID_HANDLE_VALUE)
+            return;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize))
+            return;
+        length = (size_t)fileSize.QuadPart;
+        valid = true;
+        if (length == 0)
+            return;
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping)
+            bytes = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        valid = bytes != nullptr;
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return;
+        struct stat info;
+        if (fstat(fd, &info) == 0)
+        {
+            length = (size_t)info.st_size;
+            valid = true;
+            if (length > 0)
+            {
+                void* view = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                bytes = view == MAP_FAILED ? nullptr : (const char*)view;
+                valid = bytes != nullptr;
+            }
+        }
+        // the mapping keeps the file contents reachable without the descriptor
+        close(fd);
+#endif
+    }
+
+    ~MappedFile()
+    {
+#ifdef _WIN32
+        if (bytes)
+            UnmapViewOfFile(bytes);
+        if (mapping)
+            CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE)
+            CloseHandle(file);
+#else
+        if (bytes)
+            munmap((void*)bytes, length);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isValid() const { return valid; }
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    const char* bytes;
+    size_t length;
+    bool valid;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+};
+#endif
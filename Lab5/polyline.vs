@@ -0,0 +1,57 @@
+#version 330 core
+layout (location = 0) in uint aPrevious;
+layout (location = 1) in uint aStart;
+layout (location = 2) in uint aEnd;
+layout (location = 3) in uint aNext;
+
+// thick polyline segments, one instance each (see polyline_renderer.h)
+uniform samplerBuffer points;   // x, y, width
+uniform vec4 transform;         // xy scale, zw offset
+uniform vec2 viewport;
+uniform float miterLimit;
+uniform float capExtension;
+
+vec4 fetch(uint entry)
+{
+   return texelFetch(points, int(entry & 0x7FFFFFFFu));
+}
+
+vec2 toPixels(uint entry)
+{
+   return (fetch(entry).xy * transform.xy + transform.zw) * 0.5 * viewport;
+}
+
+void main()
+{
+   vec2 start = toPixels(aStart);
+   vec2 end = toPixels(aEnd);
+   // segments between two polylines (and points that coincide on screen) are collapsed
+   if ((aStart & 0x80000000u) == 0u || distance(start, end) < 1e-4)
+   {
+       gl_Position = vec4(0.0, 0.0, 0.0, 1.0);
+       return;
+   }
+   bool atEnd = gl_VertexID >= 2;
+   float side = gl_VertexID % 2 == 0 ? -1.0 : 1.0;
+   float halfWidth = 0.5 * fetch(aStart).z;
+   vec2 direction = normalize(end - start);
+   vec2 normal = vec2(-direction.y, direction.x);
+   vec2 point = atEnd ? end : start;
+   vec2 neighbour = atEnd ? toPixels(aNext) : toPixels(aPrevious);
+   vec2 offset;
+   if (distance(neighbour, point) < 1e-4)
+   {
+       // open end: butt cap, pushed out by capExtension half widths
+       offset = normal * halfWidth * side + direction * halfWidth * capExtension * (atEnd ? 1.0 : -1.0);
+   }
+   else
+   {
+       // join: both segments move their shared corner to the same miter point
+       vec2 other = atEnd ? normalize(neighbour - end) : normalize(start - neighbour);
+       vec2 tangent = direction + other;
+       tangent = length(tangent) < 1e-4 ? direction : normalize(tangent);
+       vec2 miter = vec2(-tangent.y, tangent.x);
+       offset = miter * side * halfWidth / max(dot(miter, normal), 1.0 / miterLimit);
+   }
+   gl_Position = vec4((point + offset) / (0.5 * viewport), 0.0, 1.0);
+}
@@ -0,0 +1,374 @@
+//
+//  polyline_renderer.h
+//  Outline Drawing
+//
+//  Thick polylines of any width without GL line rasterization. Every polyline
+//  is appended to one point buffer; each segment is one instance of a 4-vertex
+//  triangle strip that the vertex shader widens in screen space, with mitered
+//  joins (clamped at MITER_LIMIT) and butt or square caps on open ends. All
+//  polylines, open or closed, are drawn with a single glDrawArraysInstanced.
+//  The shaders are polyline.vs and polyline.fs, mapped from the working
+//  directory, or compiled in from embedded_shaders.h with EMBED_SHADERS.
+//
+//  Detail follows the zoom: upload() ranks the points of every polyline with
+//  rankPolyline (in parallel over the batch), and draw() keeps only the points
+//  whose Douglas-Peucker error is at least pixelTolerance pixels on screen, so
+//  a zoomed-out view submits a fraction of them.
+//
+//      PolylineRenderer outlines;
+//      outlines.add(points, 372, true, 3.0f);      // closed, 3 px wide
+//      outlines.upload();
+//      ...
+//      outlines.setTransform(zoom, zoom, 0.0f, 0.0f);
+//      outlines.draw(width, height, color);
+//
+//  Buffer layout: the points stay on the GPU as (x, y, widthInPixels, 0) in a
+//  buffer texture. What changes with the level of detail is the index stream,
+//  the kept points of each polyline in path order with SEGMENT_BIT set where a
+//  segment starts. Instance i reads entries i .. i + 3 as (previous, start,
+//  end, next) through four attributes over the same buffer. Each polyline is
+//  padded so its ends have neighbours: a closed one with its last point in
+//  front and first two behind, an open one with its end points repeated (a
+//  neighbour equal to the point itself marks a cap). The instances straddling
+//  two polylines have no SEGMENT_BIT and collapse to nothing.
+//
+
+#ifndef POLYLINE_RENDERER_H
+#define POLYLINE_RENDERER_H
+
+#include <glad/glad.h>
+
+#include "polyline_simplify.h"
+#include "shader_source.h"
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <iostream>
+
+class PolylineRenderer
+{
+public:
+    // joins sharper than this (miter length / half width) are cut down to it
+    static constexpr float MITER_LIMIT = 4.0f;
+
+    // set on index stream entries that start a segment
+    static const GLuint SEGMENT_BIT = 0x80000000u;
+
+    // 0 = butt caps, 1 = square caps reaching half the width past the end point
+    float capExtension;
+    // points that would move the line less than this many pixels are left out; 0 draws all
+    float pixelTolerance;
+
+    PolylineRenderer()
+        : capExtension(1.0f), pixelTolerance(0.5f), program(0), VAO(0), indexVBO(0), pointVBO(0), pointTexture(0),
+          scaleX(1.0f), scaleY(1.0f), segmentCount(0), drawnSegmentCount(0), drawnPointCount(0), selectedTolerance(-1.0f)
+    {
+        program = createProgram();
+        transformLocation = glGetUniformLocation(program, "transform");
+        viewportLocation = glGetUniformLocation(program, "viewport");
+        colorLocation = glGetUniformLocation(program, "color");
+        capLocation = glGetUniformLocation(program, "capExtension");
+        glUseProgram(program);
+        glUniform1f(glGetUniformLocation(program, "miterLimit"), MITER_LIMIT);
+        glUniform1i(glGetUniformLocation(program, "points"), 0);
+        setTransform(1.0f, 1.0f, 0.0f, 0.0f);
+
+        glGenBuffers(1, &pointVBO);
+        glGenTextures(1, &pointTexture);
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &indexVBO);
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, indexVBO);
+        // previous, start, end and next entry of the segment: the same buffer, one entry apart
+        for (GLuint attribute = 0; attribute < 4; attribute++)
+        {
+            glVertexAttribIPointer(attribute, 1, GL_UNSIGNED_INT, sizeof(GLuint), (void*)(attribute * sizeof(GLuint)));
+            glEnableVertexAttribArray(attribute);
+            glVertexAttribDivisor(attribute, 1);
+        }
+        glBindVertexArray(0);
+    }
+
+    ~PolylineRenderer()
+    {
+        clear();
+    }
+
+    PolylineRenderer(const PolylineRenderer&) = delete;
+    PolylineRenderer& operator=(const PolylineRenderer&) = delete;
+
+    // append count interleaved x, y points; repeated points are dropped. Returns the
+    // number of segments added (0 if fewer than two distinct points remain)
+    // ------------------------------------------------------------------------
+    size_t add(const float* xy, size_t count, bool closed, float widthInPixels)
+    {
+        distinct.clear();
+        for (size_t i = 0; i < count; i++)
+        {
+            float x = xy[i * 2], y = xy[i * 2 + 1];
+            if (distinct.empty() || x != distinct[distinct.size() - 2] || y != distinct[distinct.size() - 1])
+            {
+                distinct.push_back(x);
+                distinct.push_back(y);
+            }
+        }
+        size_t n = distinct.size() / 2;
+        if (closed && n > 1 && distinct[0] == distinct[n * 2 - 2] && distinct[1] == distinct[n * 2 - 1])
+            n--;
+        if (n < 2)
+            return 0;
+        if (n < 3)
+            closed = false;
+
+        Polyline polyline;
+        polyline.first = points.size() / 4;
+        polyline.count = n;
+        polyline.closed = closed;
+        polylines.push_back(polyline);
+        for (size_t i = 0; i < n; i++)
+        {
+            points.push_back(distinct[i * 2]);
+            points.push_back(distinct[i * 2 + 1]);
+            points.push_back(widthInPixels);
+            points.push_back(0.0f);
+        }
+
+        size_t segments = closed ? n : n - 1;
+        segmentCount += segments;
+        return segments;
+    }
+
+    // rank the points of every polyline for level of detail and copy them to the GPU
+    // ------------------------------------------------------------------------
+    void upload()
+    {
+        parallelFor(polylines.size(), [this](size_t i)
+        {
+            Polyline& polyline = polylines[i];
+            std::vector<float> xy(polyline.count * 2);
+            for (size_t p = 0; p < polyline.count; p++)
+            {
+                xy[p * 2] = points[(polyline.first + p) * 4];
+                xy[p * 2 + 1] = points[(polyline.first + p) * 4 + 1];
+            }
+            rankPolyline(xy.data(), polyline.count, polyline.closed, polyline.lod);
+        });
+
+        glBindBuffer(GL_TEXTURE_BUFFER, pointVBO);
+        glBufferData(GL_TEXTURE_BUFFER, points.size() * sizeof(float), points.data(), GL_STATIC_DRAW);
+        glBindTexture(GL_TEXTURE_BUFFER, pointTexture);
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, pointVBO);
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+        selectedTolerance = -1.0f;
+    }
+
+    // point -> clip space is point * scale + offset; the lines stay their width in pixels
+    void setTransform(float xScale, float yScale, float xOffset, float yOffset)
+    {
+        scaleX = xScale;
+        scaleY = yScale;
+        glUseProgram(program);
+        glUniform4f(transformLocation, xScale, yScale, xOffset, yOffset);
+    }
+
+    // draw every uploaded polyline into a framebuffer of width x height pixels
+    // ------------------------------------------------------------------------
+    void draw(int width, int height, const float color[4])
+    {
+        // the error one pixel stands for: the larger of the two axes' point -> pixel scales
+        float pixelsPerUnit = 0.5f * std::max(std::fabs(scaleX) * width, std::fabs(scaleY) * height);
+        float tolerance = pixelsPerUnit > 0.0f ? pixelTolerance / pixelsPerUnit : FLT_MAX;
+        if (tolerance != selectedTolerance)
+            select(tolerance);
+        if (entries.size() < 4)
+            return;
+
+        glUseProgram(program);
+        glUniform2f(viewportLocation, (float)width, (float)height);
+        glUniform4fv(colorLocation, 1, color);
+        glUniform1f(capLocation, capExtension);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_BUFFER, pointTexture);
+        glBindVertexArray(VAO);
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)(entries.size() - 3));
+    }
+
+    // at full detail
+    size_t getSegmentCount() const
+    {
+        return segmentCount;
+    }
+    size_t getPointCount() const
+    {
+        return points.size() / 4;
+    }
+    // in the last draw
+    size_t getDrawnSegmentCount() const
+    {
+        return drawnSegmentCount;
+    }
+    size_t getDrawnPointCount() const
+    {
+        return drawnPointCount;
+    }
+
+    // delete the GL objects; call while the context is still current
+    // ------------------------------------------------------------------------
+    void clear()
+    {
+        if (VAO)
+            glDeleteVertexArrays(1, &VAO);
+        if (indexVBO)
+            glDeleteBuffers(1, &indexVBO);
+        if (pointVBO)
+            glDeleteBuffers(1, &pointVBO);
+        if (pointTexture)
+            glDeleteTextures(1, &pointTexture);
+        if (program)
+            glDeleteProgram(program);
+        VAO = indexVBO = pointVBO = pointTexture = program = 0;
+        points.clear();
+        polylines.clear();
+        entries.clear();
+        segmentCount = drawnSegmentCount = drawnPointCount = 0;
+    }
+
+private:
+    struct Polyline
+    {
+        // of its first point in points
+        size_t first;
+        size_t count;
+        bool closed;
+        PolylineLOD lod;
+    };
+
+    unsigned int program;
+    unsigned int VAO;
+    // index stream, rewritten when the level of detail changes
+    unsigned int indexVBO;
+    // points, read through pointTexture
+    unsigned int pointVBO;
+    unsigned int pointTexture;
+    GLint transformLocation;
+    GLint viewportLocation;
+    GLint colorLocation;
+    GLint capLocation;
+    float scaleX;
+    float scaleY;
+    // x, y, width, 0 per point
+    std::vector<float> points;
+    std::vector<Polyline> polylines;
+    // the index stream as last uploaded
+    std::vector<GLuint> entries;
+    // scratch for add() and select()
+    std::vector<float> distinct;
+    std::vector<GLuint> kept;
+    size_t segmentCount;
+    size_t drawnSegmentCount;
+    size_t drawnPointCount;
+    float selectedTolerance;
+
+    // rebuild the index stream from the points of every polyline with an error above tolerance
+    // ------------------------------------------------------------------------
+    void select(float tolerance)
+    {
+        entries.clear();
+        drawnSegmentCount = drawnPointCount = 0;
+        for (size_t p = 0; p < polylines.size(); p++)
+        {
+            const Polyline& polyline = polylines[p];
+            // a closed line needs three points to stay closed
+            size_t minimum = polyline.closed ? 3 : 2;
+            size_t n = std::min(std::max(lodPrefix(polyline.lod, tolerance), minimum), polyline.lod.order.size());
+            kept.assign(polyline.lod.order.begin(), polyline.lod.order.begin() + n);
+            std::sort(kept.begin(), kept.end());
+            for (size_t i = 0; i < n; i++)
+                kept[i] += (GLuint)polyline.first;
+
+            // padding in front, the points themselves, padding behind
+            entries.push_back(polyline.closed ? kept[n - 1] : kept[0]);
+            for (size_t i = 0; i < n; i++)
+            {
+                // the segment starting here is drawn, except past the last point of an open line
+                bool segment = polyline.closed || i + 1 < n;
+                entries.push_back(segment ? kept[i] | SEGMENT_BIT : kept[i]);
+            }
+            if (polyline.closed)
+            {
+                entries.push_back(kept[0]);
+                entries.push_back(kept[1]);
+            }
+            else
+                entries.push_back(kept[n - 1]);
+            drawnPointCount += n;
+            drawnSegmentCount += polyline.closed ? n : n - 1;
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, indexVBO);
+        glBufferData(GL_ARRAY_BUFFER, entries.size() * sizeof(GLuint), entries.data(), GL_STREAM_DRAW);
+        selectedTolerance = tolerance;
+    }
+
+    // polyline.vs / polyline.fs from embedded_shaders.h (EMBED_SHADERS builds) or mapped from the working
+    // directory; either way the text goes to glShaderSource in place, with its length
+    // ------------------------------------------------------------------------
+    static bool load(const char* path, ShaderSource& source)
+    {
+        if (const EmbeddedShader* embedded = findEmbeddedShader(path))
+        {
+            source.append(embedded->data, embedded->size);
+            return true;
+        }
+        std::shared_ptr<MappedFile> mapping(new MappedFile(path));
+        if (!mapping->isValid())
+        {
+            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << path << std::endl;
+            return false;
+        }
+        source.append(mapping->data(), mapping->size());
+        source.keep(mapping);
+        return true;
+    }
+
+    static unsigned int compile(GLenum type, const char* path, const char* name)
+    {
+        ShaderSource source;
+        load(path, source);
+        unsigned int shader = glCreateShader(type);
+        source.upload(shader);
+        glCompileShader(shader);
+        int success;
+        char infoLog[512];
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+        if (!success)
+        {
+            glGetShaderInfoLog(shader, 512, NULL, infoLog);
+            std::cout << "ERROR::SHADER::POLYLINE_" << name << "::COMPILATION_FAILED\n" << infoLog << std::endl;
+        }
+        return shader;
+    }
+
+    static unsigned int createProgram()
+    {
+        unsigned int vertexShader = compile(GL_VERTEX_SHADER, "polyline.vs", "VERTEX");
+        unsigned int fragmentShader = compile(GL_FRAGMENT_SHADER, "polyline.fs", "FRAGMENT");
+        unsigned int shaderProgram = glCreateProgram();
+        glAttachShader(shaderProgram, vertexShader);
+        glAttachShader(shaderProgram, fragmentShader);
+        glLinkProgram(shaderProgram);
+        int success;
+        char infoLog[512];
+        glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+        if (!success)
+        {
+            glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
+            std::cout << "ERROR::SHADER::POLYLINE_PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+        }
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+        return shaderProgram;
+    }
+};
+#endif
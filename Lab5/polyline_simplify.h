@@ -0,0 +1,169 @@
+//
+//  polyline_simplify.h
+//  Outline Drawing
+//
+//  Douglas-Peucker simplification run once, to the end, so that every point
+//  gets the error at which it joins the line instead of a yes/no answer:
+//   - rankPolyline: point indices sorted from most to least important, with
+//     the Douglas-Peucker distance of each (never larger than its parent's, so
+//     the order is the same for every tolerance)
+//   - lodPrefix: how many of them a tolerance keeps; the first lodPrefix()
+//     entries of the order, put back in path order, are the simplified line
+//   - parallelFor: runs the ranking of a batch of polylines on all cores
+//
+//      PolylineLOD lod;
+//      rankPolyline(points, 372, true, lod);
+//      size_t kept = lodPrefix(lod, 0.01f);    // points of lod.order to draw
+//
+
+#ifndef POLYLINE_SIMPLIFY_H
+#define POLYLINE_SIMPLIFY_H
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+
+struct PolylineLOD
+{
+    // point indices, most important first
+    std::vector<unsigned int> order;
+    // Douglas-Peucker distance of each entry of order, non-increasing; FLT_MAX for the anchors
+    std::vector<float> error;
+};
+
+// distance from point p to the segment a - b
+inline float segmentDistance(const float* p, const float* a, const float* b)
+{
+    float dx = b[0] - a[0], dy = b[1] - a[1];
+    float px = p[0] - a[0], py = p[1] - a[1];
+    float lengthSquared = dx * dx + dy * dy;
+    float t = lengthSquared > 0.0f ? std::min(std::max((px * dx + py * dy) / lengthSquared, 0.0f), 1.0f) : 0.0f;
+    px -= t * dx;
+    py -= t * dy;
+    return std::sqrt(px * px + py * py);
+}
+
+// rank the count interleaved x, y points of a polyline for lodPrefix(); an open line
+// keeps its end points, a closed one its first point and the point farthest from it
+// ------------------------------------------------------------------------
+inline void rankPolyline(const float* xy, size_t count, bool closed, PolylineLOD& lod)
+{
+    lod.order.clear();
+    lod.error.clear();
+    if (count == 0)
+        return;
+
+    // a closed line is ranked as the open one 0 .. count - 1, 0; index count stands for 0 again
+    size_t last = closed ? count : count - 1;
+    size_t split = last;
+    if (closed)
+    {
+        float farthest = -1.0f;
+        for (size_t i = 1; i < count; i++)
+        {
+            float d = segmentDistance(&xy[i * 2], xy, xy);
+            if (d > farthest)
+            {
+                farthest = d;
+                split = i;
+            }
+        }
+    }
+
+    lod.order.push_back(0);
+    lod.error.push_back(FLT_MAX);
+    if (split != count)
+    {
+        lod.order.push_back((unsigned int)split);
+        lod.error.push_back(FLT_MAX);
+    }
+
+    // (first, last, error of the point that created this span)
+    struct Span
+    {
+        size_t first, last;
+        float error;
+    };
+    std::vector<Span> spans;
+    spans.push_back({ 0, split, FLT_MAX });
+    if (split != last)
+        spans.push_back({ split, last, FLT_MAX });
+    while (!spans.empty())
+    {
+        Span span = spans.back();
+        spans.pop_back();
+        if (span.last - span.first < 2)
+            continue;
+        const float* a = &xy[span.first * 2];
+        const float* b = &xy[(span.last % count) * 2];
+        size_t worst = span.first + 1;
+        float worstDistance = -1.0f;
+        for (size_t i = span.first + 1; i < span.last; i++)
+        {
+            float d = segmentDistance(&xy[i * 2], a, b);
+            if (d > worstDistance)
+            {
+                worstDistance = d;
+                worst = i;
+            }
+        }
+        // clamped to the parent so a point never outranks the one it depends on
+        float error = std::min(worstDistance, span.error);
+        lod.order.push_back((unsigned int)worst);
+        lod.error.push_back(error);
+        spans.push_back({ span.first, worst, error });
+        spans.push_back({ worst, span.last, error });
+    }
+
+    // stable: points of equal error stay in the order they were split off
+    std::vector<size_t> byError(lod.order.size());
+    for (size_t i = 0; i < byError.size(); i++)
+        byError[i] = i;
+    std::stable_sort(byError.begin(), byError.end(), [&](size_t x, size_t y) { return lod.error[x] > lod.error[y]; });
+    std::vector<unsigned int> order(byError.size());
+    std::vector<float> error(byError.size());
+    for (size_t i = 0; i < byError.size(); i++)
+    {
+        order[i] = lod.order[byError[i]];
+        error[i] = lod.error[byError[i]];
+    }
+    lod.order.swap(order);
+    lod.error.swap(error);
+}
+
+// number of leading entries of lod.order whose error is above tolerance
+inline size_t lodPrefix(const PolylineLOD& lod, float tolerance)
+{
+    return std::lower_bound(lod.error.begin(), lod.error.end(), tolerance, std::greater<float>()) - lod.error.begin();
+}
+
+// body(0) .. body(count - 1), spread over the hardware threads; returns once all are done
+// ------------------------------------------------------------------------
+inline void parallelFor(size_t count, const std::function<void(size_t)>& body)
+{
+    size_t threadCount = std::min((size_t)std::max(std::thread::hardware_concurrency(), 1u), count);
+    if (threadCount <= 1)
+    {
+        for (size_t i = 0; i < count; i++)
+            body(i);
+        return;
+    }
+    // items are handed out one at a time, so a few long polylines do not stall one thread
+    std::atomic<size_t> next(0);
+    auto worker = [&]()
+    {
+        for (size_t i = next++; i < count; i = next++)
+            body(i);
+    };
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < threadCount; t++)
+        threads.emplace_back(worker);
+    worker();
+    for (size_t t = 0; t < threads.size(); t++)
+        threads[t].join();
+}
+#endif
@@ -0,0 +1,129 @@
+//
+//  shader_source.h
+//  Outline Drawing
+//
+//  GLSL source handed to glShaderSource as a list of (pointer, length) pieces
+//  instead of one concatenated string. Pieces point straight into memory-mapped
+//  shader files or into shaders embedded at build time, so loading copies no
+//  source text.
+//
+//  Embedded mode: build with EMBED_SHADERS defined and the shader files are
+//  looked up in embedded_shaders.h instead of being read from the working
+//  directory. The project's pre-build event compiles tools/embed_shaders.cpp
+//  and regenerates the header from the shaders; outside Visual Studio run
+//      embed_shaders embedded_shaders.h polyline.vs polyline.fs
+//  by hand after editing a shader.
+//
+
+#ifndef SHADER_SOURCE_H
+#define SHADER_SOURCE_H
+
+#include <glad/glad.h>
+#include "mapped_file.h"
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <cstring>
+#include <cstdint>
+
+struct EmbeddedShader
+{
+    const char* name;
+    const char* data;
+    size_t size;
+};
+
+#ifdef EMBED_SHADERS
+#include "embedded_shaders.h"
+#endif
+
+// shader embedded under the file name of path, or nullptr (always nullptr without EMBED_SHADERS)
+inline const EmbeddedShader* findEmbeddedShader(const std::string& path)
+{
+#ifdef EMBED_SHADERS
+    size_t slash = path.find_last_of("/\\");
+    const char* name = path.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+    for (size_t i = 0; i < embeddedShaderCount; i++)
+        if (std::strcmp(embeddedShaders[i].name, name) == 0)
+            return &embeddedShaders[i];
+#else
+    (void)path;
+#endif
+    return nullptr;
+}
+
+class ShaderSource
+{
+public:
+    // every file the source was assembled from, in the order it was first read
+    std::vector<std::string> files;
+
+    ShaderSource() {}
+    ShaderSource(ShaderSource&&) = default;
+    ShaderSource& operator=(ShaderSource&&) = default;
+    ShaderSource(const ShaderSource&) = delete;
+    ShaderSource& operator=(const ShaderSource&) = delete;
+
+    // reference memory owned elsewhere (a mapping kept alive with keep(), or static data)
+    void append(const char* text, size_t size)
+    {
+        if (size == 0)
+            return;
+        pieces.push_back(text);
+        lengths.push_back((GLint)size);
+    }
+
+    // generated text that has nowhere else to live
+    void appendOwned(const std::string& text)
+    {
+        owned.push_back(text);
+        append(owned.back().data(), owned.back().size());
+    }
+
+    void keep(const std::shared_ptr<MappedFile>& mapping)
+    {
+        mappings.push_back(mapping);
+    }
+
+    bool empty() const
+    {
+        return pieces.empty();
+    }
+
+    // hand all pieces to the driver with explicit lengths, no concatenation
+    void upload(GLuint shader) const
+    {
+        glShaderSource(shader, (GLsizei)pieces.size(), pieces.data(), lengths.data());
+    }
+
+    // FNV-1a over the text, continuing from hash
+    uint64_t hash(uint64_t hash) const
+    {
+        for (size_t i = 0; i < pieces.size(); i++)
+            for (GLint j = 0; j < lengths[i]; j++)
+            {
+                hash ^= (unsigned char)pieces[i][j];
+                hash *= 1099511628211ull;
+            }
+        return hash;
+    }
+
+    void clear()
+    {
+        pieces.clear();
+        lengths.clear();
+        owned.clear();
+        mappings.clear();
+        files.clear();
+    }
+
+private:
+    std::vector<const GLchar*> pieces;
+    std::vector<GLint> lengths;
+    // deque: growing it never moves the strings that pieces already point into
+    std::deque<std::string> owned;
+    std::vector<std::shared_ptr<MappedFile> > mappings;
+};
+#endif
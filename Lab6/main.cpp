@@ -1,6 +1,9 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include "shader.h"
+#include "gl_ext.h"
+#include "gl_state.h"
+#include "geometry_buffer.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -34,6 +37,8 @@ int main()
         std::cout << "Failed to initialize GLAD" << std::endl;
         return -1;
     }
+    // load the GL 4.x / ARB entry points that the 3.3 glad loader does not provide
+    loadGLExtensions((GLADloadproc)glfwGetProcAddress);
 
     // Build and compile shader
     Shader shader("vertexShader.vs", "fragmentShader.fs");
@@ -70,45 +75,14 @@ int main()
 
 
 
-    unsigned int VBOs[4], VAOs[4];
-    glGenVertexArrays(4, VAOs);
-    glGenBuffers(4, VBOs);
-
-
-    glBindVertexArray(VAOs[0]);
-    glBindBuffer(GL_ARRAY_BUFFER, VBOs[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(outerRectVertices), outerRectVertices, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-
-    glBindVertexArray(VAOs[1]);
-    glBindBuffer(GL_ARRAY_BUFFER, VBOs[1]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(innerRectVertices), innerRectVertices, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-
-    glBindVertexArray(VAOs[2]);
-    glBindBuffer(GL_ARRAY_BUFFER, VBOs[2]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(triangleVertices), triangleVertices, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-
-    glBindVertexArray(VAOs[3]);
-    glBindBuffer(GL_ARRAY_BUFFER, VBOs[3]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(greenRectVertices), greenRectVertices, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+    // every shape lives in one shared vertex buffer behind one VAO; draws only differ by their first vertex.
+    // Sized to the scene: its 15 vertices and no indices, instead of the default capacities
+    const size_t sceneVertices = 4 + 4 + 3 + 4;
+    GeometryBuffer geometry(VERTEX_FLOAT, GL_UNSIGNED_INT, sceneVertices, 0);
+    GLint outerRectFirst = geometry.allocateVertices(outerRectVertices, 4);
+    GLint innerRectFirst = geometry.allocateVertices(innerRectVertices, 4);
+    GLint triangleFirst = geometry.allocateVertices(triangleVertices, 3);
+    GLint greenRectFirst = geometry.allocateVertices(greenRectVertices, 4);
 
 
     while (!glfwWindowShouldClose(window))
@@ -124,16 +98,13 @@ int main()
         glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform));
 
 
-        glBindVertexArray(VAOs[2]);
-        glDrawArrays(GL_TRIANGLES, 0, 3);
+        geometry.drawArrays(GL_TRIANGLES, triangleFirst, 3);
 
 
-        glBindVertexArray(VAOs[0]);
-        glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+        geometry.drawArrays(GL_TRIANGLE_FAN, outerRectFirst, 4);
 
 
-        glBindVertexArray(VAOs[1]);
-        glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+        geometry.drawArrays(GL_TRIANGLE_FAN, innerRectFirst, 4);
 
 
         glm::mat4 greenTransform = glm::mat4(1.0f);
@@ -142,16 +113,14 @@ int main()
         greenTransform = glm::scale(greenTransform, glm::vec3(1.1f, 0.3f, 1.0f));
 
         glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(greenTransform));
-        glBindVertexArray(VAOs[3]);
-        glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+        geometry.drawArrays(GL_TRIANGLE_FAN, greenRectFirst, 4);
 
         glfwSwapBuffers(window);
         glfwPollEvents();
     }
 
 
-    glDeleteVertexArrays(4, VAOs);
-    glDeleteBuffers(4, VBOs);
+    geometry.clear();
 
     glfwTerminate();
     return 0;
@@ -166,5 +135,5 @@ void processInput(GLFWwindow* window)
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
-    glViewport(0, 0, width, height);
+    glState().viewport(0, 0, width, height);
 }
\ No newline at end of file
@@ -0,0 +1,220 @@
+//
+//  draw_commands.h
+//  3D Object Drawing
+//
+//  A command buffer for different meshes of one MeshRegistry: every add()
+//  records a DrawElementsIndirectCommand plus that draw's model matrix and
+//  position decode, and submit() draws the whole list with one
+//  glMultiDrawElementsIndirect. Each command draws one instance starting at
+//  baseInstance = its index, so the per-instance aDrawID attribute (a static
+//  0, 1, 2, ... buffer) tells the shader which DrawData entry is its own.
+//  Without ARB_multi_draw_indirect + ARB_base_instance (plain 3.3) the commands
+//  are issued one glDrawElementsBaseVertex each, with aDrawID set as a
+//  constant attribute; glMultiDrawElements has no way to vary it per draw.
+//
+//      DrawCommandBuffer commands(meshes.buffer());
+//      commands.add(standMesh, model);
+//      ...
+//      commands.submit();    // once per frame, with the MULTI_DRAW shader in use
+//
+
+#ifndef DRAW_COMMANDS_H
+#define DRAW_COMMANDS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "gl_ext.h"
+#include "gl_state.h"
+#include "shader.h"
+#include "mesh_registry.h"
+#include "stream_buffer.h"
+
+#include <vector>
+#include <cstring>
+#include <iostream>
+
+// layout of glMultiDrawElementsIndirect's records
+struct DrawElementsIndirectCommand
+{
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+};
+
+// mirrors "struct Draw" in vertexShader.vs (std140)
+struct DrawData
+{
+    glm::mat4 model;
+    glm::vec4 positionScale;   // xyz, w unused
+    glm::vec4 positionBias;    // xyz, w unused
+};
+
+class DrawCommandBuffer
+{
+public:
+    // size of the DrawData array in vertexShader.vs; 128 * 96 bytes fits the 16 KB minimum block size
+    static const size_t MAX_DRAWS = 128;
+    // attribute location of aDrawID in vertexShader.vs
+    static const GLuint DRAW_ID_ATTRIBUTE = 2;
+
+    explicit DrawCommandBuffer(const GeometryBuffer& buffer)
+        : geometry(buffer), uniformAlignment(queryUniformAlignment()), stream(regionBytes(uniformAlignment)), drawIDs(0), indirect(glExt().multiDrawIndirect)
+    {
+        commands.reserve(MAX_DRAWS);
+        draws.reserve(MAX_DRAWS);
+
+        geometry.bind();
+        if (indirect)
+        {
+            std::vector<GLuint> ids(MAX_DRAWS);
+            for (size_t i = 0; i < MAX_DRAWS; i++)
+                ids[i] = (GLuint)i;
+            glGenBuffers(1, &drawIDs);
+            glState().bindBuffer(GL_ARRAY_BUFFER, drawIDs);
+            glBufferData(GL_ARRAY_BUFFER, MAX_DRAWS * sizeof(GLuint), ids.data(), GL_STATIC_DRAW);
+            glVertexAttribIPointer(DRAW_ID_ATTRIBUTE, 1, GL_UNSIGNED_INT, sizeof(GLuint), (void*)0);
+            glVertexAttribDivisor(DRAW_ID_ATTRIBUTE, 1);
+            glEnableVertexAttribArray(DRAW_ID_ATTRIBUTE);
+        }
+        else
+        {
+            // left disabled, the attribute reads the constant set before each draw
+            glDisableVertexAttribArray(DRAW_ID_ATTRIBUTE);
+        }
+    }
+
+    ~DrawCommandBuffer()
+    {
+        clear();
+    }
+
+    DrawCommandBuffer(const DrawCommandBuffer&) = delete;
+    DrawCommandBuffer& operator=(const DrawCommandBuffer&) = delete;
+
+    // record one draw of mesh; it must come from this buffer's GeometryBuffer
+    // ------------------------------------------------------------------------
+    void add(const Mesh& mesh, const glm::mat4& model)
+    {
+        if (mesh.geometry != &geometry)
+        {
+            std::cout << "ERROR::DRAW_COMMANDS::MESH_FROM_OTHER_GEOMETRY_BUFFER" << std::endl;
+            return;
+        }
+        if (commands.size() == MAX_DRAWS)
+        {
+            std::cout << "ERROR::DRAW_COMMANDS::TOO_MANY_DRAWS " << MAX_DRAWS << std::endl;
+            return;
+        }
+        DrawElementsIndirectCommand command;
+        command.count = (GLuint)mesh.indexCount;
+        command.instanceCount = 1;
+        command.firstIndex = (GLuint)mesh.firstIndex;
+        command.baseVertex = mesh.baseVertex;
+        command.baseInstance = (GLuint)commands.size();
+        commands.push_back(command);
+
+        DrawData draw;
+        draw.model = model;
+        draw.positionScale = glm::vec4(mesh.position.scale, 0.0f);
+        draw.positionBias = glm::vec4(mesh.position.bias, 0.0f);
+        draws.push_back(draw);
+    }
+
+    size_t size() const
+    {
+        return commands.size();
+    }
+    bool isIndirect() const
+    {
+        return indirect;
+    }
+
+    // upload this frame's commands and per-draw data, draw them all and start a new list
+    // ------------------------------------------------------------------------
+    void submit()
+    {
+        stream.nextFrame();
+        if (commands.empty())
+            return;
+
+        // the bound range has to cover the whole declared array, even past the last draw
+        GLintptr drawOffset;
+        void* drawData = stream.allocate(MAX_DRAWS * sizeof(DrawData), uniformAlignment, drawOffset);
+        GLintptr commandOffset = 0;
+        void* commandData = indirect ? stream.allocate<DrawElementsIndirectCommand>(commands.size(), commandOffset) : nullptr;
+        if (!drawData || (indirect && !commandData))
+        {
+            reset();
+            return;
+        }
+        std::memcpy(drawData, draws.data(), draws.size() * sizeof(DrawData));
+        if (indirect)
+            std::memcpy(commandData, commands.data(), commands.size() * sizeof(DrawElementsIndirectCommand));
+        stream.flush();
+
+        glState().bindBufferRange(GL_UNIFORM_BUFFER, DRAW_DATA_BINDING, stream.getBuffer(), drawOffset, MAX_DRAWS * sizeof(DrawData));
+        geometry.bind();
+        if (indirect)
+        {
+            glState().bindBuffer(GL_DRAW_INDIRECT_BUFFER, stream.getBuffer());
+            glExt().MultiDrawElementsIndirect(GL_TRIANGLES, geometry.indexType(), (void*)commandOffset, (GLsizei)commands.size(), 0);
+        }
+        else
+        {
+            for (size_t i = 0; i < commands.size(); i++)
+            {
+                const DrawElementsIndirectCommand& command = commands[i];
+                glVertexAttribI1ui(DRAW_ID_ATTRIBUTE, command.baseInstance);
+                glDrawElementsBaseVertex(GL_TRIANGLES, command.count, geometry.indexType(),
+                    (void*)(command.firstIndex * indexSize(geometry.indexType())), command.baseVertex);
+            }
+        }
+        reset();
+    }
+
+    // delete the GL objects; call while the context is still current
+    // ------------------------------------------------------------------------
+    void clear()
+    {
+        if (drawIDs)
+            glState().deleteBuffer(drawIDs);
+        drawIDs = 0;
+        stream.clear();
+        reset();
+    }
+
+private:
+    const GeometryBuffer& geometry;
+    // GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, queried once; declared before stream, which is sized with it
+    size_t uniformAlignment;
+    StreamBuffer stream;
+    // 0 .. MAX_DRAWS - 1, read once per instance
+    GLuint drawIDs;
+    bool indirect;
+    std::vector<DrawElementsIndirectCommand> commands;
+    std::vector<DrawData> draws;
+
+    void reset()
+    {
+        commands.clear();
+        draws.clear();
+    }
+
+    // bound block offsets must be multiples of GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+    static size_t queryUniformAlignment()
+    {
+        GLint alignment = 256;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        return (size_t)alignment;
+    }
+
+    // a full frame: every DrawData entry plus every command, with room for the alignment
+    static size_t regionBytes(size_t alignment)
+    {
+        return MAX_DRAWS * (sizeof(DrawData) + sizeof(DrawElementsIndirectCommand)) + 2 * alignment;
+    }
+};
+#endif
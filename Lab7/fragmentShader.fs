@@ -1,18 +1,20 @@
 #version 330 core
 
+// variants (pick one with the Shader's define set, no runtime branch):
+//   default     - interpolated vertex color
+//   FLAT_COLOR  - one color for the whole draw, from colorFromMain
+
 in vec4 color;
 out vec4 FragColor;
-uniform bool changeColorFromMain = false;
+#ifdef FLAT_COLOR
 uniform vec4 colorFromMain;
+#endif
 
 void main()
 {
-    vec4 finalColor;
-    if(changeColorFromMain == false)
-        finalColor = color;
-     else
-        finalColor = colorFromMain;
-
-
-    FragColor = finalColor;
+#ifdef FLAT_COLOR
+    FragColor = colorFromMain;
+#else
+    FragColor = color;
+#endif
 }
\ No newline at end of file
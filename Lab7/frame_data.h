@@ -0,0 +1,88 @@
+//
+//  frame_data.h
+//  3D Object Drawing
+//
+//  Per-frame camera data shared by every program through one std140 uniform
+//  buffer bound at FRAME_DATA_BINDING, so view/projection are uploaded once per
+//  frame instead of once per program. Each frame's block is written into a
+//  StreamBuffer region, so the update never waits for draws still reading the
+//  previous frame's block.
+//
+
+#ifndef FRAME_DATA_H
+#define FRAME_DATA_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "camera.h"
+#include "gl_state.h"
+#include "shader.h"
+#include "stream_buffer.h"
+
+#include <cstring>
+
+// mirrors "layout (std140) uniform FrameData" in vertexShader.vs
+struct FrameData
+{
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 viewProjection;
+    glm::vec4 cameraPosition;   // xyz, w unused
+    float time;
+    float padding[3];           // std140 rounds the block up to a multiple of 16 bytes
+};
+
+class FrameUniforms
+{
+public:
+    FrameData data;
+
+    FrameUniforms() : stream(blockStride()), lastZoom(-1.0f), lastAspect(-1.0f) {}
+
+    // recompute the camera matrices and upload the block; call once per frame before drawing
+    // ------------------------------------------------------------------------
+    void update(Camera& camera, float aspect, float time, float nearPlane = 0.1f, float farPlane = 100.0f)
+    {
+        // the projection only depends on zoom and aspect, so skip glm::perspective while they hold still
+        if (camera.Zoom != lastZoom || aspect != lastAspect)
+        {
+            data.projection = glm::perspective(glm::radians(camera.Zoom), aspect, nearPlane, farPlane);
+            lastZoom = camera.Zoom;
+            lastAspect = aspect;
+        }
+        data.view = camera.GetViewMatrix();
+        data.viewProjection = data.projection * data.view;
+        data.cameraPosition = glm::vec4(camera.Position, 1.0f);
+        data.time = time;
+
+        stream.nextFrame();
+        GLintptr offset;
+        void* block = stream.allocate(sizeof(FrameData), blockStride(), offset);
+        if (!block)
+            return;
+        std::memcpy(block, &data, sizeof(FrameData));
+        stream.flush();
+        glState().bindBufferRange(GL_UNIFORM_BUFFER, FRAME_DATA_BINDING, stream.getBuffer(), offset, sizeof(FrameData));
+    }
+
+private:
+    StreamBuffer stream;
+    float lastZoom;
+    float lastAspect;
+
+public:
+    FrameUniforms(const FrameUniforms&) = delete;
+    FrameUniforms& operator=(const FrameUniforms&) = delete;
+
+private:
+    // bound block offsets must be multiples of GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+    static size_t blockStride()
+    {
+        GLint alignment = 256;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        return ((sizeof(FrameData) + alignment - 1) / alignment) * alignment;
+    }
+};
+#endif
@@ -0,0 +1,278 @@
+//
+//  geometry_buffer.h
+//  3D Object Drawing
+//
+//  One large vertex buffer and one large index buffer shared by every mesh of a
+//  vertex format, behind a single VAO. Meshes get element ranges from a
+//  free-list allocator and are drawn with their offsets (glDrawElementsBaseVertex,
+//  or the first vertex of glDrawArrays), so switching meshes binds nothing.
+//  Indices stay relative to their own mesh; baseVertex moves them into place.
+//  Vertices are stored in the buffer's VertexFormat (see vertex_format.h) and
+//  indices as its index type; since they are mesh-relative, 8-bit indices
+//  serve any mesh of up to 256 vertices.
+//
+//      GeometryBuffer geometry;
+//      GLint baseVertex = geometry.allocateVertices(boxVertices, 8);    // already in geometry.format()
+//      GLint firstIndex = geometry.allocateIndices(boxIndices, 36);    // of geometry.indexType()
+//      geometry.drawElements(GL_TRIANGLES, 36, firstIndex, baseVertex);
+//
+
+#ifndef GEOMETRY_BUFFER_H
+#define GEOMETRY_BUFFER_H
+
+#include <glad/glad.h>
+#include "gl_state.h"
+#include "vertex_format.h"
+
+#include <map>
+#include <iostream>
+
+// first-fit free list over [0, capacity) in whole elements; freed neighbours are merged again
+class RangeAllocator
+{
+public:
+    static const size_t npos = (size_t)-1;
+
+    explicit RangeAllocator(size_t capacity = 0) : total(capacity), end(0), inUse(0) {}
+
+    // start of a free range of count elements, or npos if it does not fit
+    // ------------------------------------------------------------------------
+    size_t allocate(size_t count)
+    {
+        for (std::map<size_t, size_t>::iterator it = holes.begin(); it != holes.end(); ++it)
+        {
+            if (it->second < count)
+                continue;
+            size_t offset = it->first;
+            size_t rest = it->second - count;
+            holes.erase(it);
+            if (rest > 0)
+                holes[offset + count] = rest;
+            inUse += count;
+            return offset;
+        }
+        // no hole is big enough: bump the end
+        if (total - end < count)
+            return npos;
+        size_t offset = end;
+        end += count;
+        inUse += count;
+        return offset;
+    }
+
+    // ------------------------------------------------------------------------
+    void release(size_t offset, size_t count)
+    {
+        inUse -= count;
+        std::map<size_t, size_t>::iterator next = holes.lower_bound(offset);
+        if (next != holes.end() && offset + count == next->first)
+        {
+            count += next->second;
+            next = holes.erase(next);
+        }
+        if (next != holes.begin())
+        {
+            std::map<size_t, size_t>::iterator previous = next;
+            --previous;
+            if (previous->first + previous->second == offset)
+            {
+                offset = previous->first;
+                count += previous->second;
+                holes.erase(previous);
+            }
+        }
+        // a hole touching the end just moves the end back
+        if (offset + count == end)
+            end = offset;
+        else
+            holes[offset] = count;
+    }
+
+    void grow(size_t capacity)
+    {
+        total = capacity;
+    }
+
+    size_t capacity() const
+    {
+        return total;
+    }
+    // highest element ever handed out + 1; everything past it has never been written
+    size_t highWater() const
+    {
+        return end;
+    }
+    size_t used() const
+    {
+        return inUse;
+    }
+
+private:
+    size_t total;
+    size_t end;
+    size_t inUse;
+    // offset -> count of every free range below end
+    std::map<size_t, size_t> holes;
+};
+
+class GeometryBuffer
+{
+public:
+    explicit GeometryBuffer(VertexFormat format = VERTEX_FLOAT, GLenum indexType = GL_UNSIGNED_INT, size_t vertexCapacity = 1 << 14, size_t indexCapacity = 1 << 16)
+        : VAO(0), VBO(0), EBO(0), vertexFormat(format), elementType(indexType), vertices(vertexCapacity), indices(indexCapacity)
+    {
+        glGenVertexArrays(1, &VAO);
+        VBO = createBuffer(vertexCapacity * vertexSize(format));
+        EBO = createBuffer(indexCapacity * indexSize(indexType));
+        glState().bindVertexArray(VAO);
+        glState().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        setVertexAttributes();
+    }
+
+    ~GeometryBuffer()
+    {
+        clear();
+    }
+
+    GeometryBuffer(const GeometryBuffer&) = delete;
+    GeometryBuffer& operator=(const GeometryBuffer&) = delete;
+
+    // copy count vertices (already in format()) in and return their base vertex; grows the buffer if it is full
+    // ------------------------------------------------------------------------
+    GLint allocateVertices(const void* data, size_t count)
+    {
+        const size_t size = vertexSize(vertexFormat);
+        size_t offset = vertices.allocate(count);
+        if (offset == RangeAllocator::npos)
+        {
+            grow(VBO, vertices, count, size);
+            setVertexAttributes();
+            offset = vertices.allocate(count);
+        }
+        glState().bindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferSubData(GL_ARRAY_BUFFER, offset * size, count * size, data);
+        return (GLint)offset;
+    }
+
+    // copy count indices of indexType() in (relative to their mesh's first vertex) and return the first index
+    // ------------------------------------------------------------------------
+    GLint allocateIndices(const void* data, size_t count)
+    {
+        const size_t size = indexSize(elementType);
+        size_t offset = indices.allocate(count);
+        if (offset == RangeAllocator::npos)
+        {
+            grow(EBO, indices, count, size);
+            glState().bindVertexArray(VAO);
+            glState().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+            offset = indices.allocate(count);
+        }
+        // written through GL_ARRAY_BUFFER so no VAO's element binding changes
+        glState().bindBuffer(GL_ARRAY_BUFFER, EBO);
+        glBufferSubData(GL_ARRAY_BUFFER, offset * size, count * size, data);
+        return (GLint)offset;
+    }
+
+    void releaseVertices(GLint baseVertex, size_t count)
+    {
+        vertices.release((size_t)baseVertex, count);
+    }
+    void releaseIndices(GLint firstIndex, size_t count)
+    {
+        indices.release((size_t)firstIndex, count);
+    }
+
+    void bind() const
+    {
+        glState().bindVertexArray(VAO);
+    }
+
+    // ------------------------------------------------------------------------
+    void drawArrays(GLenum mode, GLint baseVertex, GLsizei count) const
+    {
+        bind();
+        glDrawArrays(mode, baseVertex, count);
+    }
+    void drawElements(GLenum mode, GLsizei count, GLint firstIndex, GLint baseVertex) const
+    {
+        bind();
+        glDrawElementsBaseVertex(mode, count, elementType, (void*)(firstIndex * indexSize(elementType)), baseVertex);
+    }
+
+    VertexFormat format() const
+    {
+        return vertexFormat;
+    }
+    GLenum indexType() const
+    {
+        return elementType;
+    }
+    GLuint vertexArray() const
+    {
+        return VAO;
+    }
+    GLuint vertexBuffer() const
+    {
+        return VBO;
+    }
+    GLuint indexBuffer() const
+    {
+        return EBO;
+    }
+
+    // delete the GL objects; call while the context is still current
+    // ------------------------------------------------------------------------
+    void clear()
+    {
+        if (VAO)
+            glState().deleteVertexArray(VAO);
+        if (VBO)
+            glState().deleteBuffer(VBO);
+        if (EBO)
+            glState().deleteBuffer(EBO);
+        VAO = VBO = EBO = 0;
+    }
+
+private:
+    GLuint VAO;
+    GLuint VBO;
+    GLuint EBO;
+    VertexFormat vertexFormat;
+    GLenum elementType;
+    RangeAllocator vertices;
+    RangeAllocator indices;
+
+    static GLuint createBuffer(size_t bytes)
+    {
+        GLuint buffer;
+        glGenBuffers(1, &buffer);
+        glState().bindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ARRAY_BUFFER, bytes, NULL, GL_STATIC_DRAW);
+        return buffer;
+    }
+
+    // the attribute pointers capture the bound GL_ARRAY_BUFFER, so they are set again after a grow
+    void setVertexAttributes()
+    {
+        glState().bindVertexArray(VAO);
+        glState().bindBuffer(GL_ARRAY_BUFFER, VBO);
+        vertexFormatAttributes(vertexFormat);
+    }
+
+    // replace buffer with one at least twice as large, copying the used part on the GPU; offsets stay valid
+    void grow(GLuint& buffer, RangeAllocator& allocator, size_t count, size_t elementSize)
+    {
+        size_t capacity = allocator.capacity() * 2;
+        while (capacity - allocator.highWater() < count)
+            capacity = capacity * 2 + count;
+        GLuint larger = createBuffer(capacity * elementSize);
+        glState().bindBuffer(GL_COPY_READ_BUFFER, buffer);
+        glState().bindBuffer(GL_COPY_WRITE_BUFFER, larger);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, allocator.highWater() * elementSize);
+        glState().deleteBuffer(buffer);
+        buffer = larger;
+        allocator.grow(capacity);
+        std::cout << "GEOMETRY_BUFFER::GROW to " << capacity << " elements" << std::endl;
+    }
+};
+#endif
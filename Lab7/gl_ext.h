@@ -0,0 +1,195 @@
+//
+//  gl_ext.h
+//  3D Object Drawing
+//
+//  glad in this project is generated for plain GL 3.3 core, so entry points from
+//  newer core versions / ARB extensions are declared and loaded here instead.
+//
+
+#ifndef GL_EXT_H
+#define GL_EXT_H
+
+#include <glad/glad.h>
+
+#include <cstring>
+
+// ARB_get_program_binary (core in 4.1)
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+// KHR_parallel_shader_compile / ARB_parallel_shader_compile
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+// ARB_separate_shader_objects (core in 4.1)
+#ifndef GL_PROGRAM_SEPARABLE
+#define GL_PROGRAM_SEPARABLE 0x8258
+#endif
+#ifndef GL_VERTEX_SHADER_BIT
+#define GL_VERTEX_SHADER_BIT 0x00000001
+#endif
+#ifndef GL_FRAGMENT_SHADER_BIT
+#define GL_FRAGMENT_SHADER_BIT 0x00000002
+#endif
+
+// ARB_buffer_storage (core in 4.4)
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+#ifndef GL_DYNAMIC_STORAGE_BIT
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#endif
+#ifndef GL_CLIENT_STORAGE_BIT
+#define GL_CLIENT_STORAGE_BIT 0x0200
+#endif
+
+// ARB_multi_draw_indirect (core in 4.3), with the baseInstance field of ARB_base_instance (4.2)
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+
+typedef void (APIENTRYP PFN_glGetProgramBinary)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+typedef void (APIENTRYP PFN_glProgramBinary)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+typedef void (APIENTRYP PFN_glProgramParameteri)(GLuint program, GLenum pname, GLint value);
+typedef void (APIENTRYP PFN_glMaxShaderCompilerThreads)(GLuint count);
+typedef void (APIENTRYP PFN_glGenProgramPipelines)(GLsizei n, GLuint* pipelines);
+typedef void (APIENTRYP PFN_glDeleteProgramPipelines)(GLsizei n, const GLuint* pipelines);
+typedef void (APIENTRYP PFN_glBindProgramPipeline)(GLuint pipeline);
+typedef void (APIENTRYP PFN_glUseProgramStages)(GLuint pipeline, GLbitfield stages, GLuint program);
+typedef void (APIENTRYP PFN_glActiveShaderProgram)(GLuint pipeline, GLuint program);
+typedef void (APIENTRYP PFN_glValidateProgramPipeline)(GLuint pipeline);
+typedef void (APIENTRYP PFN_glGetProgramPipelineiv)(GLuint pipeline, GLenum pname, GLint* params);
+typedef void (APIENTRYP PFN_glGetProgramPipelineInfoLog)(GLuint pipeline, GLsizei bufSize, GLsizei* length, GLchar* infoLog);
+typedef void (APIENTRYP PFN_glBufferStorage)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+typedef void (APIENTRYP PFN_glMultiDrawElementsIndirect)(GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride);
+
+// function pointers and capability flags filled in by loadGLExtensions()
+struct GLExtensions
+{
+    bool loaded = false;
+
+    bool programBinary = false;
+    PFN_glGetProgramBinary GetProgramBinary = nullptr;
+    PFN_glProgramBinary ProgramBinary = nullptr;
+    PFN_glProgramParameteri ProgramParameteri = nullptr;
+
+    // GL_COMPLETION_STATUS_KHR can be polled without blocking
+    bool parallelShaderCompile = false;
+    PFN_glMaxShaderCompilerThreads MaxShaderCompilerThreads = nullptr;
+
+    // single-stage programs combined in program pipeline objects
+    bool separateShaderObjects = false;
+    PFN_glGenProgramPipelines GenProgramPipelines = nullptr;
+    PFN_glDeleteProgramPipelines DeleteProgramPipelines = nullptr;
+    PFN_glBindProgramPipeline BindProgramPipeline = nullptr;
+    PFN_glUseProgramStages UseProgramStages = nullptr;
+    PFN_glActiveShaderProgram ActiveShaderProgram = nullptr;
+    PFN_glValidateProgramPipeline ValidateProgramPipeline = nullptr;
+    PFN_glGetProgramPipelineiv GetProgramPipelineiv = nullptr;
+    PFN_glGetProgramPipelineInfoLog GetProgramPipelineInfoLog = nullptr;
+
+    // immutable buffer storage that can stay mapped while the GPU reads it
+    bool bufferStorage = false;
+    PFN_glBufferStorage BufferStorage = nullptr;
+
+    // a whole command buffer from GL_DRAW_INDIRECT_BUFFER in one call, baseInstance honoured
+    bool multiDrawIndirect = false;
+    PFN_glMultiDrawElementsIndirect MultiDrawElementsIndirect = nullptr;
+};
+
+inline GLExtensions& glExt()
+{
+    static GLExtensions extensions;
+    return extensions;
+}
+
+// true if the context is at least the given GL version
+inline bool hasGLVersion(int major, int minor)
+{
+    return GLVersion.major > major || (GLVersion.major == major && GLVersion.minor >= minor);
+}
+
+// true if the current context advertises the named extension
+inline bool hasGLExtension(const char* name)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; i++)
+    {
+        const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+        if (extension && std::strcmp(extension, name) == 0)
+            return true;
+    }
+    return false;
+}
+
+// call once right after gladLoadGLLoader with the same loader
+// ------------------------------------------------------------------------
+inline void loadGLExtensions(GLADloadproc load)
+{
+    GLExtensions& ext = glExt();
+
+    if (hasGLVersion(4, 1) || hasGLExtension("GL_ARB_get_program_binary"))
+    {
+        ext.GetProgramBinary = (PFN_glGetProgramBinary)load("glGetProgramBinary");
+        ext.ProgramBinary = (PFN_glProgramBinary)load("glProgramBinary");
+        ext.ProgramParameteri = (PFN_glProgramParameteri)load("glProgramParameteri");
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        ext.programBinary = ext.GetProgramBinary && ext.ProgramBinary && ext.ProgramParameteri && formats > 0;
+    }
+
+    if (hasGLExtension("GL_KHR_parallel_shader_compile"))
+        ext.MaxShaderCompilerThreads = (PFN_glMaxShaderCompilerThreads)load("glMaxShaderCompilerThreadsKHR");
+    else if (hasGLExtension("GL_ARB_parallel_shader_compile"))
+        ext.MaxShaderCompilerThreads = (PFN_glMaxShaderCompilerThreads)load("glMaxShaderCompilerThreadsARB");
+    if (ext.MaxShaderCompilerThreads)
+    {
+        // let the driver pick how many compiler threads to use
+        ext.MaxShaderCompilerThreads(0xFFFFFFFFu);
+        ext.parallelShaderCompile = true;
+    }
+
+    if (hasGLVersion(4, 1) || hasGLExtension("GL_ARB_separate_shader_objects"))
+    {
+        ext.ProgramParameteri = (PFN_glProgramParameteri)load("glProgramParameteri");
+        ext.GenProgramPipelines = (PFN_glGenProgramPipelines)load("glGenProgramPipelines");
+        ext.DeleteProgramPipelines = (PFN_glDeleteProgramPipelines)load("glDeleteProgramPipelines");
+        ext.BindProgramPipeline = (PFN_glBindProgramPipeline)load("glBindProgramPipeline");
+        ext.UseProgramStages = (PFN_glUseProgramStages)load("glUseProgramStages");
+        ext.ActiveShaderProgram = (PFN_glActiveShaderProgram)load("glActiveShaderProgram");
+        ext.ValidateProgramPipeline = (PFN_glValidateProgramPipeline)load("glValidateProgramPipeline");
+        ext.GetProgramPipelineiv = (PFN_glGetProgramPipelineiv)load("glGetProgramPipelineiv");
+        ext.GetProgramPipelineInfoLog = (PFN_glGetProgramPipelineInfoLog)load("glGetProgramPipelineInfoLog");
+        ext.separateShaderObjects = ext.ProgramParameteri && ext.GenProgramPipelines && ext.DeleteProgramPipelines &&
+            ext.BindProgramPipeline && ext.UseProgramStages && ext.ActiveShaderProgram && ext.ValidateProgramPipeline &&
+            ext.GetProgramPipelineiv && ext.GetProgramPipelineInfoLog;
+    }
+
+    if (hasGLVersion(4, 4) || hasGLExtension("GL_ARB_buffer_storage"))
+    {
+        ext.BufferStorage = (PFN_glBufferStorage)load("glBufferStorage");
+        ext.bufferStorage = ext.BufferStorage != nullptr;
+    }
+
+    if (hasGLVersion(4, 3) || (hasGLExtension("GL_ARB_multi_draw_indirect") && hasGLExtension("GL_ARB_base_instance")))
+    {
+        ext.MultiDrawElementsIndirect = (PFN_glMultiDrawElementsIndirect)load("glMultiDrawElementsIndirect");
+        ext.multiDrawIndirect = ext.MultiDrawElementsIndirect != nullptr;
+    }
+
+    ext.loaded = true;
+}
+
+#endif
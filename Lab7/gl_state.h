@@ -0,0 +1,248 @@
+//
+//  gl_state.h
+//  3D Object Drawing
+//
+//  Thin shadow of the GL state the labs change most: bound program / pipeline,
+//  VAO, buffer bindings, enabled capabilities, blend and depth functions and the
+//  viewport. Calls that would set what is already set never reach the driver.
+//  Code that changes this state with raw gl* calls must call invalidate() after.
+//
+//      glState().bindVertexArray(cube_VAO);   // issued
+//      glState().bindVertexArray(cube_VAO);   // elided
+//
+
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <glad/glad.h>
+#include "gl_ext.h"
+
+#include <map>
+
+class GLStateCache
+{
+public:
+    // state changes sent to / skipped before the driver
+    struct Stats
+    {
+        unsigned int issued = 0;
+        unsigned int elided = 0;
+    };
+
+    GLStateCache()
+    {
+        invalidate();
+    }
+
+    // forget everything; the next call of each kind always reaches the driver
+    // ------------------------------------------------------------------------
+    void invalidate()
+    {
+        program = pipeline = vertexArray = UNKNOWN;
+        buffers.clear();
+        elementBuffers.clear();
+        capabilities.clear();
+        blendSource = blendDestination = depthFunction = UNKNOWN;
+        depthWrite = -1;
+        viewportRect[0] = viewportRect[1] = viewportRect[2] = viewportRect[3] = -1;
+    }
+
+    // ------------------------------------------------------------------------
+    void useProgram(GLuint id)
+    {
+        if (changed(program, id))
+            glUseProgram(id);
+    }
+    void bindProgramPipeline(GLuint id)
+    {
+        if (changed(pipeline, id))
+            glExt().BindProgramPipeline(id);
+    }
+    // ------------------------------------------------------------------------
+    void bindVertexArray(GLuint id)
+    {
+        if (changed(vertexArray, id))
+            glBindVertexArray(id);
+    }
+    // the element array binding belongs to the bound VAO, so it is tracked per VAO
+    // ------------------------------------------------------------------------
+    void bindBuffer(GLenum target, GLuint id)
+    {
+        if (target == GL_ELEMENT_ARRAY_BUFFER && vertexArray == UNKNOWN)
+        {
+            frameStats().issued++;
+            glBindBuffer(target, id);
+            return;
+        }
+        GLuint& bound = target == GL_ELEMENT_ARRAY_BUFFER ? binding(elementBuffers, vertexArray) : binding(buffers, target);
+        if (changed(bound, id))
+            glBindBuffer(target, id);
+    }
+    // indexed uniform / transform feedback binding; always issued since offsets move every frame,
+    // but GL binds the generic target as well, so that is recorded
+    void bindBufferRange(GLenum target, GLuint index, GLuint id, GLintptr offset, GLsizeiptr size)
+    {
+        frameStats().issued++;
+        binding(buffers, target) = id;
+        glBindBufferRange(target, index, id, offset, size);
+    }
+    // ------------------------------------------------------------------------
+    void enable(GLenum capability)
+    {
+        set(capability, true);
+    }
+    void disable(GLenum capability)
+    {
+        set(capability, false);
+    }
+    void set(GLenum capability, bool enabled)
+    {
+        std::map<GLenum, int>::iterator it = capabilities.find(capability);
+        if (it != capabilities.end() && it->second == (int)enabled)
+        {
+            frameStats().elided++;
+            return;
+        }
+        capabilities[capability] = (int)enabled;
+        frameStats().issued++;
+        if (enabled)
+            glEnable(capability);
+        else
+            glDisable(capability);
+    }
+    // ------------------------------------------------------------------------
+    void blendFunc(GLenum source, GLenum destination)
+    {
+        if (blendSource == source && blendDestination == destination)
+        {
+            frameStats().elided++;
+            return;
+        }
+        blendSource = source;
+        blendDestination = destination;
+        frameStats().issued++;
+        glBlendFunc(source, destination);
+    }
+    void depthFunc(GLenum function)
+    {
+        if (changed(depthFunction, function))
+            glDepthFunc(function);
+    }
+    void depthMask(bool write)
+    {
+        if (depthWrite == (int)write)
+        {
+            frameStats().elided++;
+            return;
+        }
+        depthWrite = (int)write;
+        frameStats().issued++;
+        glDepthMask(write ? GL_TRUE : GL_FALSE);
+    }
+    // ------------------------------------------------------------------------
+    void viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+    {
+        if (viewportRect[0] == x && viewportRect[1] == y && viewportRect[2] == width && viewportRect[3] == height)
+        {
+            frameStats().elided++;
+            return;
+        }
+        viewportRect[0] = x;
+        viewportRect[1] = y;
+        viewportRect[2] = width;
+        viewportRect[3] = height;
+        frameStats().issued++;
+        glViewport(x, y, width, height);
+    }
+
+    // deleting a bound object unbinds it in GL, so the cache has to forget it as well
+    // ------------------------------------------------------------------------
+    void deleteProgram(GLuint id)
+    {
+        if (program == id)
+            program = UNKNOWN;
+        glDeleteProgram(id);
+    }
+    void deleteVertexArray(GLuint id)
+    {
+        if (vertexArray == id)
+            vertexArray = UNKNOWN;
+        elementBuffers.erase(id);
+        glDeleteVertexArrays(1, &id);
+    }
+    void deleteBuffer(GLuint id)
+    {
+        for (std::map<GLenum, GLuint>::iterator it = buffers.begin(); it != buffers.end(); ++it)
+            if (it->second == id)
+                it->second = UNKNOWN;
+        for (std::map<GLuint, GLuint>::iterator it = elementBuffers.begin(); it != elementBuffers.end(); ++it)
+            if (it->second == id)
+                it->second = UNKNOWN;
+        glDeleteBuffers(1, &id);
+    }
+
+    // counters of the frame in progress
+    static Stats& frameStats()
+    {
+        static Stats stats;
+        return stats;
+    }
+    // counters of the last completed frame
+    static Stats& lastFrameStats()
+    {
+        static Stats stats;
+        return stats;
+    }
+    // call once at the start of every frame
+    static void beginFrame()
+    {
+        lastFrameStats() = frameStats();
+        frameStats() = Stats();
+    }
+
+private:
+    static const GLuint UNKNOWN = 0xFFFFFFFFu;
+
+    GLuint program;
+    GLuint pipeline;
+    GLuint vertexArray;
+    // target -> bound buffer, and VAO -> bound element buffer
+    std::map<GLenum, GLuint> buffers;
+    std::map<GLuint, GLuint> elementBuffers;
+    // capability -> enabled (absent = unknown)
+    std::map<GLenum, int> capabilities;
+    GLenum blendSource;
+    GLenum blendDestination;
+    GLenum depthFunction;
+    int depthWrite;
+    GLint viewportRect[4];
+
+    // counts the call and returns true if it has to reach the driver
+    static bool changed(GLuint& current, GLuint value)
+    {
+        if (current == value)
+        {
+            frameStats().elided++;
+            return false;
+        }
+        current = value;
+        frameStats().issued++;
+        return true;
+    }
+
+    static GLuint& binding(std::map<GLuint, GLuint>& bindings, GLuint key)
+    {
+        std::map<GLuint, GLuint>::iterator it = bindings.find(key);
+        if (it == bindings.end())
+            it = bindings.insert(std::make_pair(key, (GLuint)UNKNOWN)).first;
+        return it->second;
+    }
+};
+
+// the cache of the (single) GL context
+inline GLStateCache& glState()
+{
+    static GLStateCache state;
+    return state;
+}
+#endif
@@ -5,8 +5,13 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include "gl_ext.h"
+#include "gl_state.h"
 #include "shader.h"
 #include "camera.h"
+#include "frame_data.h"
+#include "mesh_registry.h"
+#include "draw_commands.h"
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void mouse_callback(GLFWwindow* window, double xpos, double ypos);
@@ -58,9 +63,17 @@ int main()
         std::cout << "Failed to initialize GLAD" << std::endl;
         return -1;
     }
-
-    glEnable(GL_DEPTH_TEST);
-    Shader ourShader("vertexShader.vs", "fragmentShader.fs");
+    // load the GL 4.x / ARB entry points that the 3.3 glad loader does not provide
+    loadGLExtensions((GLADloadproc)glfwGetProcAddress);
+
+    glState().enable(GL_DEPTH_TEST);
+    // vertex layout of every mesh; the MULTI_DRAW shader reads each draw's model matrix and
+    // position decode from the DrawData block instead of per-draw uniforms
+    const VertexFormat meshFormat = VERTEX_SNORM16;
+    std::vector<std::string> meshDefines = vertexFormatDefines(meshFormat);
+    meshDefines.push_back("MULTI_DRAW");
+    Shader ourShader("vertexShader.vs", "fragmentShader.fs", meshDefines);
+    FrameUniforms frameUniforms;
 
     // Center cube vertices (now in 3D)
     float centerCube[] = {
@@ -141,80 +154,41 @@ int main()
         1, 0, 4
     };
 
-    // Set up VAOs and VBOs for each component
-    unsigned int centerVAO, centerVBO, centerEBO;
-    glGenVertexArrays(1, &centerVAO);
-    glGenBuffers(1, &centerVBO);
-    glGenBuffers(1, &centerEBO);
-
-    glBindVertexArray(centerVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, centerVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(centerCube), centerCube, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, centerEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    // Blade VAO setup
-    unsigned int bladeVAO, bladeVBO, bladeEBO;
-    glGenVertexArrays(1, &bladeVAO);
-    glGenBuffers(1, &bladeVBO);
-    glGenBuffers(1, &bladeEBO);
-
-    glBindVertexArray(bladeVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, bladeVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(blade), blade, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bladeEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    // Stand VAO setup
-    unsigned int standVAO, standVBO, standEBO;
-    glGenVertexArrays(1, &standVAO);
-    glGenBuffers(1, &standVBO);
-    glGenBuffers(1, &standEBO);
-
-    glBindVertexArray(standVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, standVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(stand), stand, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, standEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    // Table VAO setup
-    unsigned int tableVAO, tableVBO, tableEBO;
-    glGenVertexArrays(1, &tableVAO);
-    glGenBuffers(1, &tableVBO);
-    glGenBuffers(1, &tableEBO);
-
-    glBindVertexArray(tableVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, tableVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(table), table, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, tableEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+    // Set up one mesh per component; the four boxes share a single index buffer
+    // every part is an 8-vertex box, so 8-bit indices address them all
+    MeshRegistry meshes(meshFormat, smallestIndexType(8));
+    const GLsizei indexCount = sizeof(indices) / sizeof(indices[0]);
+    const Mesh& centerMesh = meshes.add(centerCube, sizeof(centerCube), indices, indexCount);
+    const Mesh& bladeMesh = meshes.add(blade, sizeof(blade), indices, indexCount);
+    const Mesh& standMesh = meshes.add(stand, sizeof(stand), indices, indexCount);
+    const Mesh& tableMesh = meshes.add(table, sizeof(table), indices, indexCount);
+    meshes.report();
+
+    // the whole fan is recorded here and submitted as one multi-draw per frame
+    DrawCommandBuffer commands(meshes.buffer());
+
+    // when the last frame's uniform and state counters were printed
+    float lastStatsTime = 0.0f;
 
     // render loop
     while (!glfwWindowShouldClose(window))
     {
+        // roll the uniform and state-change counters over to their lastFrame*Stats()
+        Shader::beginFrame();
+        GLStateCache::beginFrame();
+
         float currentFrame = static_cast<float>(glfwGetTime());
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
+        // once a second, how many glUniform* and state calls the shadow copies saved last frame
+        if (currentFrame - lastStatsTime >= 1.0f)
+        {
+            lastStatsTime = currentFrame;
+            const Shader::UniformStats& uniforms = Shader::lastFrameUniformStats();
+            const GLStateCache::Stats& state = GLStateCache::lastFrameStats();
+            std::cout << "UNIFORMS: " << uniforms.issued << " issued, " << uniforms.elided << " elided last frame" << std::endl;
+            std::cout << "GL_STATE: " << state.issued << " issued, " << state.elided << " elided last frame" << std::endl;
+        }
 
         processInput(window);
 
@@ -223,11 +197,7 @@ int main()
 
         ourShader.use();
 
-        glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
-        ourShader.setMat4("projection", projection);
-
-        glm::mat4 view = camera.GetViewMatrix();
-        ourShader.setMat4("view", view);
+        frameUniforms.update(camera, (float)SCR_WIDTH / (float)SCR_HEIGHT, currentFrame);
 
         // Update fan rotation
         if (isFanRotating)
@@ -239,50 +209,35 @@ int main()
 
         // Draw stand (at bottom)
         glm::mat4 model = glm::mat4(1.0f);
-        ourShader.setMat4("model", model);
-        glBindVertexArray(standVAO);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+        commands.add(standMesh, model);
 
         // Draw table (at bottom of the scene)
         model = glm::mat4(1.0f);
-        ourShader.setMat4("model", model);
-        glBindVertexArray(tableVAO);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+        commands.add(tableMesh, model);
 
         // Draw center cube (elevated)
         model = glm::mat4(1.0f);
         model = glm::translate(model, glm::vec3(0.0f, 0.0f, 0.0f));  // Already elevated in vertices
-        ourShader.setMat4("model", model);
-        glBindVertexArray(centerVAO);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+        commands.add(centerMesh, model);
 
         // Draw the four blades
-        glBindVertexArray(bladeVAO);
         for (int i = 0; i < 4; i++)
         {
             model = glm::mat4(1.0f);
             model = glm::rotate(model, glm::radians(fanRotation + (i * 90.0f)), glm::vec3(0.0f, 0.0f, 1.0f));
-            ourShader.setMat4("model", model);
-            glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+            commands.add(bladeMesh, model);
         }
 
+        // stand, table, hub and blades in one submission
+        commands.submit();
+
         glfwSwapBuffers(window);
         glfwPollEvents();
     }
 
     // Cleanup
-    glDeleteVertexArrays(1, &centerVAO);
-    glDeleteVertexArrays(1, &bladeVAO);
-    glDeleteVertexArrays(1, &standVAO);
-    glDeleteVertexArrays(1, &tableVAO);
-    glDeleteBuffers(1, &centerVBO);
-    glDeleteBuffers(1, &bladeVBO);
-    glDeleteBuffers(1, &standVBO);
-    glDeleteBuffers(1, &centerEBO);
-    glDeleteBuffers(1, &bladeEBO);
-    glDeleteBuffers(1, &standEBO);
-    glDeleteBuffers(1, &tableVBO);
-    glDeleteBuffers(1, &tableEBO);
+    commands.clear();
+    meshes.clear();
 
     glfwTerminate();
     return 0;
@@ -336,7 +291,7 @@ void processInput(GLFWwindow* window)
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
     // make sure the viewport matches the new window dimensions
-    glViewport(0, 0, width, height);
+    glState().viewport(0, 0, width, height);
 }
 
 
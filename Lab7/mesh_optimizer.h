@@ -0,0 +1,197 @@
+//
+//  mesh_optimizer.h
+//  3D Object Drawing
+//
+//  Offline-style processing of indexed triangle meshes before upload:
+//   - optimizeVertexCache: reorders triangles with Tipsify (Sander, Nehab and
+//     Barczak 2007) so vertices are reused while still in the post-transform cache
+//   - optimizeVertexFetch: renumbers vertices in first-use order so the vertex
+//     fetch walks memory forwards; unused vertices are dropped
+//   - smallestIndexType / narrowIndices: 8- or 16-bit indices when they fit
+//   - acmr: average cache miss ratio (transformed vertices per triangle, 0.5 - 3.0)
+//
+//      float before = acmr(indices, 36, 8);
+//      optimizeVertexCache(indices, 36, 8);
+//      size_t used = optimizeVertexFetch(vertices, 6 * sizeof(float), 8, indices, 36);
+//      GLenum type = smallestIndexType(used);
+//
+
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <glad/glad.h>
+#include "vertex_format.h"
+
+#include <vector>
+#include <cstring>
+#include <cstdint>
+
+// entries of the FIFO post-transform cache the optimizer plans for and acmr() simulates
+const size_t VERTEX_CACHE_SIZE = 16;
+
+// transformed vertices per triangle through a FIFO cache of cacheSize entries
+// ------------------------------------------------------------------------
+inline float acmr(const unsigned int* indices, size_t indexCount, size_t vertexCount, size_t cacheSize = VERTEX_CACHE_SIZE)
+{
+    if (indexCount < 3)
+        return 0.0f;
+    // vertex -> time it entered the cache; it is a hit while fewer than cacheSize misses happened since
+    std::vector<size_t> entered(vertexCount, 0);
+    size_t misses = 0;
+    for (size_t i = 0; i < indexCount; i++)
+    {
+        unsigned int v = indices[i];
+        if (entered[v] == 0 || misses - entered[v] >= cacheSize)
+        {
+            misses++;
+            entered[v] = misses;
+        }
+    }
+    return (float)misses / (float)(indexCount / 3);
+}
+
+// reorder the triangles of indices in place for post-transform cache reuse (Tipsify)
+// ------------------------------------------------------------------------
+inline void optimizeVertexCache(unsigned int* indices, size_t indexCount, size_t vertexCount, size_t cacheSize = VERTEX_CACHE_SIZE)
+{
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0)
+        return;
+
+    // vertex -> triangles using it, as offsets into one flat array
+    std::vector<unsigned int> live(vertexCount, 0);
+    for (size_t i = 0; i < triangleCount * 3; i++)
+        live[indices[i]]++;
+    std::vector<size_t> firstTriangle(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++)
+        firstTriangle[v + 1] = firstTriangle[v] + live[v];
+    std::vector<unsigned int> triangles(triangleCount * 3);
+    std::vector<size_t> fill(firstTriangle.begin(), firstTriangle.end() - 1);
+    for (size_t i = 0; i < triangleCount * 3; i++)
+        triangles[fill[indices[i]]++] = (unsigned int)(i / 3);
+
+    std::vector<unsigned int> output;
+    output.reserve(triangleCount * 3);
+    std::vector<bool> emitted(triangleCount, false);
+    // vertex -> time stamp of its last cache entry
+    std::vector<size_t> cacheTime(vertexCount, 0);
+    std::vector<unsigned int> deadEnd;
+    std::vector<unsigned int> candidates;
+    size_t time = cacheSize + 1;
+    size_t cursor = 0;
+    long fanning = 0;
+
+    while (fanning >= 0)
+    {
+        // emit every remaining triangle around the fanning vertex
+        candidates.clear();
+        for (size_t t = firstTriangle[fanning]; t < firstTriangle[fanning + 1]; t++)
+        {
+            unsigned int triangle = triangles[t];
+            if (emitted[triangle])
+                continue;
+            for (int corner = 0; corner < 3; corner++)
+            {
+                unsigned int v = indices[triangle * 3 + corner];
+                output.push_back(v);
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                live[v]--;
+                if (time - cacheTime[v] > cacheSize)
+                    cacheTime[v] = time++;
+            }
+            emitted[triangle] = true;
+        }
+
+        // next fan: the candidate that will still be cached after its remaining triangles, oldest first
+        fanning = -1;
+        long best = -1;
+        for (size_t c = 0; c < candidates.size(); c++)
+        {
+            unsigned int v = candidates[c];
+            if (live[v] == 0)
+                continue;
+            long priority = 0;
+            if (time - cacheTime[v] + 2 * live[v] <= cacheSize)
+                priority = (long)(time - cacheTime[v]);
+            if (priority > best)
+            {
+                best = priority;
+                fanning = v;
+            }
+        }
+        if (fanning >= 0)
+            continue;
+
+        // dead end: a recently used vertex with triangles left, else the next one in input order
+        while (!deadEnd.empty() && fanning < 0)
+        {
+            unsigned int v = deadEnd.back();
+            deadEnd.pop_back();
+            if (live[v] > 0)
+                fanning = v;
+        }
+        while (fanning < 0 && cursor < vertexCount)
+        {
+            if (live[cursor] > 0)
+                fanning = (long)cursor;
+            cursor++;
+        }
+    }
+    std::memcpy(indices, output.data(), output.size() * sizeof(unsigned int));
+}
+
+// renumber vertices (vertexSize bytes each) in order of first use and move them to match;
+// returns the number of vertices still referenced, which now come first
+// ------------------------------------------------------------------------
+inline size_t optimizeVertexFetch(void* vertices, size_t vertexSize, size_t vertexCount, unsigned int* indices, size_t indexCount)
+{
+    const unsigned int UNUSED = 0xFFFFFFFFu;
+    std::vector<unsigned int> remap(vertexCount, UNUSED);
+    unsigned int next = 0;
+    for (size_t i = 0; i < indexCount; i++)
+    {
+        unsigned int& target = remap[indices[i]];
+        if (target == UNUSED)
+            target = next++;
+        indices[i] = target;
+    }
+
+    unsigned char* bytes = (unsigned char*)vertices;
+    std::vector<unsigned char> reordered(next * vertexSize);
+    for (size_t v = 0; v < vertexCount; v++)
+        if (remap[v] != UNUSED)
+            std::memcpy(&reordered[remap[v] * vertexSize], bytes + v * vertexSize, vertexSize);
+    std::memcpy(vertices, reordered.data(), reordered.size());
+    return next;
+}
+
+// narrowest index type that can address vertexCount vertices
+inline GLenum smallestIndexType(size_t vertexCount)
+{
+    if (vertexCount <= 0x100)
+        return GL_UNSIGNED_BYTE;
+    if (vertexCount <= 0x10000)
+        return GL_UNSIGNED_SHORT;
+    return GL_UNSIGNED_INT;
+}
+
+// indices converted to type, replacing out; every index must fit
+// ------------------------------------------------------------------------
+inline void narrowIndices(const unsigned int* indices, size_t indexCount, GLenum type, std::vector<unsigned char>& out)
+{
+    out.resize(indexCount * indexSize(type));
+    for (size_t i = 0; i < indexCount; i++)
+    {
+        if (type == GL_UNSIGNED_BYTE)
+            out[i] = (unsigned char)indices[i];
+        else if (type == GL_UNSIGNED_SHORT)
+        {
+            uint16_t index = (uint16_t)indices[i];
+            std::memcpy(&out[i * 2], &index, 2);
+        }
+        else
+            std::memcpy(&out[i * 4], &indices[i], 4);
+    }
+}
+#endif
@@ -0,0 +1,230 @@
+//
+//  mesh_registry.h
+//  3D Object Drawing
+//
+//  Content-addressed mesh uploads: every vertex and index list is hashed, and
+//  data identical to an earlier upload reuses that range of the shared
+//  GeometryBuffer instead of being copied again. Boxes built from the same
+//  index list share one index range; all meshes share one VAO.
+//  Vertices are packed into the registry's VertexFormat before hashing, so two
+//  meshes that differ only in position and size share one packed range.
+//  Before that every mesh goes through mesh_optimizer.h: triangles reordered
+//  for the post-transform cache, vertices for fetch order, indices narrowed to
+//  the registry's index type.
+//
+//      MeshRegistry meshes(VERTEX_SNORM16, GL_UNSIGNED_BYTE);
+//      const Mesh& standMesh = meshes.add(stand, sizeof(stand), indices, 36);
+//      meshes.report();
+//      ...
+//      shader.setVec3("positionScale", standMesh.position.scale);    // packed formats only
+//      shader.setVec3("positionBias", standMesh.position.bias);
+//      standMesh.draw();
+//
+
+#ifndef MESH_REGISTRY_H
+#define MESH_REGISTRY_H
+
+#include <glad/glad.h>
+#include "geometry_buffer.h"
+#include "mesh_optimizer.h"
+
+#include <map>
+#include <vector>
+#include <utility>
+#include <cstring>
+#include <cstdint>
+#include <iostream>
+
+// an indexed triangle mesh: its ranges inside the registry's GeometryBuffer
+struct Mesh
+{
+    const GeometryBuffer* geometry = nullptr;
+    GLint baseVertex = 0;
+    GLint firstIndex = 0;
+    GLsizei vertexCount = 0;
+    GLsizei indexCount = 0;
+    // decode of the packed positions into the mesh's own coordinates
+    PositionTransform position;
+
+    void draw() const
+    {
+        if (geometry)
+            geometry->drawElements(GL_TRIANGLES, indexCount, firstIndex, baseVertex);
+    }
+};
+
+class MeshRegistry
+{
+public:
+    // bytes handed to add() against bytes actually uploaded
+    struct Stats
+    {
+        size_t requestedBytes = 0;
+        size_t uploadedBytes = 0;
+        unsigned int uploads = 0;
+        unsigned int ranges = 0;
+        // vertex transforms through the simulated cache, before and after optimization
+        size_t triangles = 0;
+        float missesBefore = 0.0f;
+        float missesAfter = 0.0f;
+
+        size_t savedBytes() const
+        {
+            return requestedBytes - uploadedBytes;
+        }
+        float acmrBefore() const
+        {
+            return triangles ? missesBefore / triangles : 0.0f;
+        }
+        float acmrAfter() const
+        {
+            return triangles ? missesAfter / triangles : 0.0f;
+        }
+    };
+
+    // indexType has to address the largest mesh; indices are relative to their mesh
+    explicit MeshRegistry(VertexFormat format = VERTEX_FLOAT, GLenum indexType = GL_UNSIGNED_INT) : geometry(format, indexType) {}
+    ~MeshRegistry()
+    {
+        clear();
+    }
+
+    MeshRegistry(const MeshRegistry&) = delete;
+    MeshRegistry& operator=(const MeshRegistry&) = delete;
+
+    // interleaved vec3 position + vec3 color vertices with 32-bit indices relative to the mesh
+    // ------------------------------------------------------------------------
+    const Mesh& add(const float* vertices, size_t vertexBytes, const unsigned int* indices, size_t indexCount)
+    {
+        size_t vertexCount = vertexBytes / (6 * sizeof(float));
+        optimizedVertices.assign(vertices, vertices + vertexCount * 6);
+        optimizedIndices.assign(indices, indices + indexCount);
+        const size_t triangles = indexCount / 3;
+        stats.triangles += triangles;
+        stats.missesBefore += acmr(indices, indexCount, vertexCount) * triangles;
+        optimizeVertexCache(optimizedIndices.data(), indexCount, vertexCount);
+        vertexCount = optimizeVertexFetch(optimizedVertices.data(), 6 * sizeof(float), vertexCount, optimizedIndices.data(), indexCount);
+        stats.missesAfter += acmr(optimizedIndices.data(), indexCount, vertexCount) * triangles;
+        if (indexSize(smallestIndexType(vertexCount)) > indexSize(geometry.indexType()))
+        {
+            std::cout << "ERROR::MESH_REGISTRY::INDEX_TYPE_TOO_SMALL for " << vertexCount << " vertices" << std::endl;
+            // draws nothing
+            static const Mesh empty = Mesh();
+            return empty;
+        }
+
+        PositionTransform position = packVertices(optimizedVertices.data(), vertexCount, geometry.format(), packed);
+        stats.requestedBytes += vertexBytes - packed.size();
+        GLint baseVertex = range(VERTICES, packed.data(), packed.size(), vertexCount);
+        narrowIndices(optimizedIndices.data(), indexCount, geometry.indexType(), packed);
+        stats.requestedBytes += indexCount * sizeof(unsigned int) - packed.size();
+        GLint firstIndex = range(INDICES, packed.data(), packed.size(), indexCount);
+
+        std::pair<GLint, GLint> key(baseVertex, firstIndex);
+        typedef std::multimap<std::pair<GLint, GLint>, Mesh>::iterator Iterator;
+        std::pair<Iterator, Iterator> same = meshes.equal_range(key);
+        for (Iterator it = same.first; it != same.second; ++it)
+            if (it->second.position.scale == position.scale && it->second.position.bias == position.bias)
+                return it->second;
+        Mesh& mesh = meshes.insert(std::make_pair(key, Mesh()))->second;
+        mesh.position = position;
+        mesh.geometry = &geometry;
+        mesh.baseVertex = baseVertex;
+        mesh.firstIndex = firstIndex;
+        mesh.vertexCount = (GLsizei)vertexCount;
+        mesh.indexCount = (GLsizei)indexCount;
+        return mesh;
+    }
+
+    // the buffer every mesh of this registry is drawn from
+    const GeometryBuffer& buffer() const
+    {
+        return geometry;
+    }
+
+    const Stats& getStats() const
+    {
+        return stats;
+    }
+
+    void report() const
+    {
+        std::cout << "MESH_REGISTRY: " << stats.uploads << " uploads in " << stats.ranges << " ranges, "
+            << stats.savedBytes() << " of " << stats.requestedBytes << " bytes saved, ACMR "
+            << stats.acmrBefore() << " -> " << stats.acmrAfter() << std::endl;
+    }
+
+    // drop every mesh and the GL objects; call while the context is still current
+    // ------------------------------------------------------------------------
+    void clear()
+    {
+        geometry.clear();
+        meshes.clear();
+        entries.clear();
+        byHash.clear();
+    }
+
+private:
+    enum Kind
+    {
+        VERTICES,
+        INDICES
+    };
+    struct Entry
+    {
+        Kind kind;
+        // CPU copy compared on a hash hit, so a collision can never alias two meshes
+        std::vector<unsigned char> bytes;
+        GLint first;
+    };
+    GeometryBuffer geometry;
+    std::vector<Entry> entries;
+    std::multimap<uint64_t, size_t> byHash;
+    // (base vertex, first index) -> meshes with their decode; map nodes keep returned references valid
+    std::multimap<std::pair<GLint, GLint>, Mesh> meshes;
+    // scratch for add(): the optimized copy, then its packed vertices / narrowed indices
+    std::vector<float> optimizedVertices;
+    std::vector<unsigned int> optimizedIndices;
+    std::vector<unsigned char> packed;
+    Stats stats;
+
+    // first element of a range holding exactly these bytes; identical content uploaded earlier is shared
+    GLint range(Kind kind, const void* data, size_t size, size_t count)
+    {
+        stats.requestedBytes += size;
+        stats.uploads++;
+        uint64_t key = hash(data, size);
+        for (std::multimap<uint64_t, size_t>::iterator it = byHash.find(key); it != byHash.end() && it->first == key; ++it)
+        {
+            const Entry& entry = entries[it->second];
+            // the hash only narrows the search, the bytes decide
+            if (entry.kind == kind && entry.bytes.size() == size && std::memcmp(entry.bytes.data(), data, size) == 0)
+                return entry.first;
+        }
+
+        Entry entry;
+        entry.kind = kind;
+        entry.bytes.assign((const unsigned char*)data, (const unsigned char*)data + size);
+        entry.first = kind == VERTICES ? geometry.allocateVertices(data, count)
+                                       : geometry.allocateIndices(data, count);
+        byHash.insert(std::make_pair(key, entries.size()));
+        entries.push_back(std::move(entry));
+        stats.uploadedBytes += size;
+        stats.ranges++;
+        return entries.back().first;
+    }
+
+    // FNV-1a, as used for the program cache keys
+    static uint64_t hash(const void* data, size_t size)
+    {
+        const unsigned char* bytes = (const unsigned char*)data;
+        uint64_t value = 14695981039346656037ull;
+        for (size_t i = 0; i < size; i++)
+        {
+            value ^= bytes[i];
+            value *= 1099511628211ull;
+        }
+        return value;
+    }
+};
+#endif
@@ -10,142 +10,475 @@
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include "gl_state.h"
+#include "program_cache.h"
+#include "shader_preprocessor.h"
 
 #include <string>
-#include <fstream>
-#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
+// fixed binding points of the uniform blocks shared by every program
+enum UniformBlockBinding
+{
+    FRAME_DATA_BINDING = 0,
+    DRAW_DATA_BINDING = 1
+};
+
 class Shader
 {
 public:
     unsigned int ID;
     // constructor generates the shader on the fly
     // ------------------------------------------------------------------------
-    Shader(const char* vertexPath, const char* fragmentPath)
+    // defines are injected after #version, e.g. { "FLAT_COLOR" }; see shader_preprocessor.h
+    Shader(const char* vertexPath, const char* fragmentPath, const std::vector<std::string>& variantDefines = std::vector<std::string>()) : Shader()
     {
+        vertexDefines = fragmentDefines = variantDefines;
         // 1. retrieve the vertex/fragment source code from filePath
-        std::string vertexCode;
-        std::string fragmentCode;
-        std::ifstream vShaderFile;
-        std::ifstream fShaderFile;
-        // ensure ifstream objects can throw exceptions:
-        vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-        fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-        try
-        {
-            // open files
-            vShaderFile.open(vertexPath);
-            fShaderFile.open(fragmentPath);
-            std::stringstream vShaderStream, fShaderStream;
-            // read file's buffer contents into streams
-            vShaderStream << vShaderFile.rdbuf();
-            fShaderStream << fShaderFile.rdbuf();
-            // close file handlers
-            vShaderFile.close();
-            fShaderFile.close();
-            // convert stream into string
-            vertexCode = vShaderStream.str();
-            fragmentCode = fShaderStream.str();
-        }
-        catch (std::ifstream::failure& e)
-        {
-            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
-        }
-        const char* vShaderCode = vertexCode.c_str();
-        const char* fShaderCode = fragmentCode.c_str();
-        // 2. compile shaders
-        unsigned int vertex, fragment;
-        // vertex shader
-        vertex = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(vertex, 1, &vShaderCode, NULL);
-        glCompileShader(vertex);
-        checkCompileErrors(vertex, "VERTEX");
-        // fragment Shader
-        fragment = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(fragment, 1, &fShaderCode, NULL);
-        glCompileShader(fragment);
-        checkCompileErrors(fragment, "FRAGMENT");
-        // shader Program
-        ID = glCreateProgram();
-        glAttachShader(ID, vertex);
-        glAttachShader(ID, fragment);
-        glLinkProgram(ID);
-        checkCompileErrors(ID, "PROGRAM");
-        // delete the shaders as they're linked into our program now and no longer necessary
-        glDeleteShader(vertex);
-        glDeleteShader(fragment);
-
+        readSources(vertexPath, fragmentPath);
+        // 2. restore the linked program from the binary cache, or submit compile and link
+        compileStages();
+        linkProgram();
+        // 3. check the results and reflect the active uniforms once so the setters never ask the driver by name
+        finishBuild();
+    }
+    // a single separable stage (GL_VERTEX_SHADER or GL_FRAGMENT_SHADER), compiled once and combined with
+    // other stages at bind time by a ProgramPipeline instead of being linked into every pair; see shader_pipeline.h
+    // ------------------------------------------------------------------------
+    Shader(GLenum stage, const char* path, const std::vector<std::string>& variantDefines = std::vector<std::string>()) : Shader()
+    {
+        vertexDefines = fragmentDefines = variantDefines;
+        separableStage = stage;
+        stagePath = path;
+        // without separate shader objects the pipeline links its stages into one program itself
+        if (!glExt().separateShaderObjects)
+            return;
+        readSources(stage == GL_VERTEX_SHADER ? path : nullptr, stage == GL_FRAGMENT_SHADER ? path : nullptr);
+        compileStages();
+        linkProgram();
+        finishBuild();
+    }
+    // GL_VERTEX_SHADER / GL_FRAGMENT_SHADER for a separable stage, GL_NONE for a complete program
+    GLenum stage() const
+    {
+        return separableStage;
+    }
+    // true once the driver has finished compiling and linking; only non-blocking with KHR_parallel_shader_compile
+    // ------------------------------------------------------------------------
+    bool isReady() const
+    {
+        if (!building)
+            return true;
+        if (!glExt().parallelShaderCompile)
+            return true;
+        GLint done = GL_FALSE;
+        glGetProgramiv(ID, GL_COMPLETION_STATUS_KHR, &done);
+        return done == GL_TRUE;
     }
     // activate the shader
     // ------------------------------------------------------------------------
     void use() const
     {
-        glUseProgram(ID);
+        glState().useProgram(ID);
+    }
+    // looks up a uniform in the table built after link; -1 (ignored by glUniform*) if it is not active
+    // ------------------------------------------------------------------------
+    GLint uniformLocation(const std::string& name) const
+    {
+        return uniformLocation(name.c_str());
+    }
+    GLint uniformLocation(const char* name) const
+    {
+        const UniformEntry* entry = findUniform(name);
+        return entry ? entry->location : -1;
+    }
+    // GL type reported by glGetActiveUniform (GL_FLOAT_MAT4, GL_BOOL, ...), GL_NONE if not active
+    GLenum uniformType(const char* name) const
+    {
+        const UniformEntry* entry = findUniform(name);
+        return entry ? entry->type : GL_NONE;
     }
     // utility uniform functions
     // ------------------------------------------------------------------------
     void setBool(const std::string& name, bool value) const
     {
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+        GLint location = uniformLocation(name);
+        if (updateShadow(location, &value, sizeof(value)))
+            glUniform1i(location, (int)value);
     }
     // ------------------------------------------------------------------------
     void setInt(const std::string& name, int value) const
     {
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+        GLint location = uniformLocation(name);
+        if (updateShadow(location, &value, sizeof(value)))
+            glUniform1i(location, value);
     }
     // ------------------------------------------------------------------------
     void setFloat(const std::string& name, float value) const
     {
-        glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+        GLint location = uniformLocation(name);
+        if (updateShadow(location, &value, sizeof(value)))
+            glUniform1f(location, value);
     }
     // ------------------------------------------------------------------------
     void setVec2(const std::string& name, const glm::vec2& value) const
     {
-        glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+        GLint location = uniformLocation(name);
+        if (updateShadow(location, &value, sizeof(value)))
+            glUniform2fv(location, 1, &value[0]);
     }
     void setVec2(const std::string& name, float x, float y) const
     {
-        glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
+        setVec2(name, glm::vec2(x, y));
     }
     // ------------------------------------------------------------------------
     void setVec3(const std::string& name, const glm::vec3& value) const
     {
-        glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+        GLint location = uniformLocation(name);
+        if (updateShadow(location, &value, sizeof(value)))
+            glUniform3fv(location, 1, &value[0]);
     }
     void setVec3(const std::string& name, float x, float y, float z) const
     {
-        glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+        setVec3(name, glm::vec3(x, y, z));
     }
     // ------------------------------------------------------------------------
     void setVec4(const std::string& name, const glm::vec4& value) const
     {
-        glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+        GLint location = uniformLocation(name);
+        if (updateShadow(location, &value, sizeof(value)))
+            glUniform4fv(location, 1, &value[0]);
     }
     void setVec4(const std::string& name, float x, float y, float z, float w) const
     {
-        glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w);
+        setVec4(name, glm::vec4(x, y, z, w));
     }
     // ------------------------------------------------------------------------
     void setMat2(const std::string& name, const glm::mat2& mat) const
     {
-        glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        GLint location = uniformLocation(name);
+        if (updateShadow(location, &mat, sizeof(mat)))
+            glUniformMatrix2fv(location, 1, GL_FALSE, &mat[0][0]);
     }
     // ------------------------------------------------------------------------
     void setMat3(const std::string& name, const glm::mat3& mat) const
     {
-        glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        GLint location = uniformLocation(name);
+        if (updateShadow(location, &mat, sizeof(mat)))
+            glUniformMatrix3fv(location, 1, GL_FALSE, &mat[0][0]);
     }
     // ------------------------------------------------------------------------
     void setMat4(const std::string& name, const glm::mat4& mat) const
     {
-        glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        GLint location = uniformLocation(name);
+        if (updateShadow(location, &mat, sizeof(mat)))
+            glUniformMatrix4fv(location, 1, GL_FALSE, &mat[0][0]);
+    }
+
+    // remembers the last value sent to each location of this program; returns false when the
+    // value is unchanged and the glUniform* call can be skipped
+    // ------------------------------------------------------------------------
+    bool updateShadow(GLint location, const void* value, size_t size) const
+    {
+        if (location < 0)
+            return false;
+        if ((size_t)location >= shadows.size() || size > sizeof(UniformShadow::data))
+        {
+            uniformStats().issued++;
+            return true;
+        }
+        UniformShadow& shadow = shadows[location];
+        if (shadow.size == size && std::memcmp(shadow.data, value, size) == 0)
+        {
+            uniformStats().elided++;
+            return false;
+        }
+        std::memcpy(shadow.data, value, size);
+        shadow.size = (unsigned char)size;
+        uniformStats().issued++;
+        return true;
+    }
+
+    // uniform updates sent to / skipped before the driver, over all programs
+    struct UniformStats
+    {
+        unsigned int issued = 0;
+        unsigned int elided = 0;
+    };
+    // counters of the frame in progress
+    static UniformStats& uniformStats()
+    {
+        static UniformStats stats;
+        return stats;
+    }
+    // counters of the last completed frame
+    static UniformStats& lastFrameUniformStats()
+    {
+        static UniformStats stats;
+        return stats;
+    }
+    // call once at the start of every frame
+    static void beginFrame()
+    {
+        lastFrameUniformStats() = uniformStats();
+        uniformStats() = UniformStats();
     }
 
 private:
+    struct UniformEntry
+    {
+        std::string name;
+        GLint location;
+        GLenum type;
+    };
+    // active uniforms of the linked program, sorted by name
+    std::vector<UniformEntry> uniforms;
+    // last value sent to each uniform location, indexed by location; size 0 = nothing sent yet
+    struct UniformShadow
+    {
+        float data[16];
+        unsigned char size = 0;
+    };
+    mutable std::vector<UniformShadow> shadows;
+
+    // binary search by C string, so lookups never build a std::string
+    // ------------------------------------------------------------------------
+    const UniformEntry* findUniform(const char* name) const
+    {
+        std::vector<UniformEntry>::const_iterator it = std::lower_bound(uniforms.begin(), uniforms.end(), name,
+            [](const UniformEntry& entry, const char* key) { return std::strcmp(entry.name.c_str(), key) < 0; });
+        if (it != uniforms.end() && std::strcmp(it->name.c_str(), name) == 0)
+            return &*it;
+        return nullptr;
+    }
+
+    // GLSL 3.30 has no layout(binding = N), so shared blocks are attached after every link
+    // ------------------------------------------------------------------------
+    void bindUniformBlock(const char* name, GLuint binding)
+    {
+        GLuint index = glGetUniformBlockIndex(ID, name);
+        if (index != GL_INVALID_INDEX)
+            glUniformBlockBinding(ID, index, binding);
+    }
+
+    // enumerate the active uniforms of the program with glGetActiveUniform and store name -> location
+    // ------------------------------------------------------------------------
+    void buildUniformTable()
+    {
+        uniforms.clear();
+        GLint count = 0, maxLength = 0;
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+        std::vector<GLchar> nameBuffer(maxLength > 0 ? maxLength : 1);
+        for (GLint i = 0; i < count; i++)
+        {
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(ID, (GLuint)i, (GLsizei)nameBuffer.size(), &length, &size, &type, nameBuffer.data());
+            std::string name(nameBuffer.data(), length);
+            GLint location = glGetUniformLocation(ID, name.c_str());
+            // uniforms inside blocks have no location
+            if (location < 0)
+                continue;
+            uniforms.push_back({ name, location, type });
+            // arrays are reported as "name[0]"; make them reachable by their plain name too
+            if (length > 3 && name.compare(length - 3, 3, "[0]") == 0)
+                uniforms.push_back({ name.substr(0, length - 3), location, type });
+        }
+        std::sort(uniforms.begin(), uniforms.end(),
+            [](const UniformEntry& a, const UniformEntry& b) { return a.name < b.name; });
+
+        // a new program starts with unknown values, so forget everything shadowed so far
+        GLint maxLocation = -1;
+        for (const UniformEntry& entry : uniforms)
+            maxLocation = std::max(maxLocation, entry.location);
+        shadows.assign(maxLocation + 1, UniformShadow());
+    }
+
+    friend class ShaderBuilder;
+    friend class ProgramFuture;
+    friend class ShaderWatcher;
+    friend class ProgramPipeline;
+
+    // preprocessor defines of each stage, the same set unless two separable stages were combined
+    // into one program, and the files the sources came from
+    std::vector<std::string> vertexDefines;
+    std::vector<std::string> fragmentDefines;
+    std::vector<std::string> sourceFiles;
+    // sources are only kept between readSources() and finishBuild()
+    ShaderSource vertexSource;
+    ShaderSource fragmentSource;
+    unsigned int vertexStage = 0;
+    unsigned int fragmentStage = 0;
+    uint64_t cacheKey = 0;
+    bool fromCache = false;
+    bool building = false;
+    // separable stages only: which stage and the file it is read from
+    GLenum separableStage = GL_NONE;
+    std::string stagePath;
+
+    // an empty shader, filled in step by step by the constructor or by ShaderBuilder
+    Shader() : ID(0) {}
+
+    // expand includes and inject defines; remembers every file read so the watcher can follow them
+    // ------------------------------------------------------------------------
+    // a null path leaves that stage out (separable programs)
+    // ------------------------------------------------------------------------
+    bool readSources(const char* vertexPath, const char* fragmentPath)
+    {
+        bool success = true;
+        if (vertexPath)
+            success &= ShaderPreprocessor::load(vertexPath, vertexDefines, vertexSource);
+        if (fragmentPath)
+            success &= ShaderPreprocessor::load(fragmentPath, fragmentDefines, fragmentSource);
+        collectSourceFiles();
+        return success;
+    }
+
+    // one complete program from two separable stage shaders, each with its own defines
+    // ------------------------------------------------------------------------
+    bool readSources(const Shader& vertex, const Shader& fragment)
+    {
+        vertexDefines = vertex.vertexDefines;
+        fragmentDefines = fragment.fragmentDefines;
+        bool success = ShaderPreprocessor::load(vertex.stagePath, vertexDefines, vertexSource);
+        success &= ShaderPreprocessor::load(fragment.stagePath, fragmentDefines, fragmentSource);
+        collectSourceFiles();
+        return success;
+    }
+
+    void collectSourceFiles()
+    {
+        sourceFiles = vertexSource.files;
+        sourceFiles.insert(sourceFiles.end(), fragmentSource.files.begin(), fragmentSource.files.end());
+    }
+
+    // separable programs must be flagged before they are linked or restored from a binary
+    // ------------------------------------------------------------------------
+    GLuint createProgram() const
+    {
+        GLuint program = glCreateProgram();
+        if (separableStage != GL_NONE)
+            glExt().ProgramParameteri(program, GL_PROGRAM_SEPARABLE, GL_TRUE);
+        return program;
+    }
+
+    // create the program and queue both stage compiles; no status is queried here so the driver can run ahead
+    // ------------------------------------------------------------------------
+    void compileStages()
+    {
+        building = true;
+        cacheKey = ProgramCache::key({ &vertexSource, &fragmentSource });
+        // a separable stage links to a different binary than the same source in a complete program
+        if (separableStage != GL_NONE)
+            cacheKey = (cacheKey ^ separableStage) * 1099511628211ull;
+        ID = createProgram();
+        fromCache = ProgramCache::load(ID, cacheKey);
+        if (!fromCache)
+            compileSources();
+    }
+
+    // queue the compile of each stage this program has
+    // ------------------------------------------------------------------------
+    void compileSources()
+    {
+        // vertex shader
+        if (separableStage != GL_FRAGMENT_SHADER)
+        {
+            vertexStage = glCreateShader(GL_VERTEX_SHADER);
+            vertexSource.upload(vertexStage);
+            glCompileShader(vertexStage);
+        }
+        // fragment Shader
+        if (separableStage != GL_VERTEX_SHADER)
+        {
+            fragmentStage = glCreateShader(GL_FRAGMENT_SHADER);
+            fragmentSource.upload(fragmentStage);
+            glCompileShader(fragmentStage);
+        }
+    }
+
+    // queue the link; compile errors surface through the link status in finishBuild()
+    // ------------------------------------------------------------------------
+    void linkProgram()
+    {
+        if (fromCache)
+            return;
+        if (vertexStage)
+            glAttachShader(ID, vertexStage);
+        if (fragmentStage)
+            glAttachShader(ID, fragmentStage);
+        ProgramCache::markRetrievable(ID);
+        glLinkProgram(ID);
+    }
+
+    // first status query of the build, cached binaries included; blocks until the driver is done with this program
+    // ------------------------------------------------------------------------
+    bool finishBuild()
+    {
+        bool success = true;
+        if (fromCache)
+        {
+            GLint linked = GL_FALSE;
+            glGetProgramiv(ID, GL_LINK_STATUS, &linked);
+            if (!linked)
+            {
+                // the driver rejected the binary, which leaves the program failed: build a fresh one
+                // from the sources, still loaded, and let the lines below store its binary instead
+                ProgramCache::discard(cacheKey);
+                glDeleteProgram(ID);
+                ID = createProgram();
+                fromCache = false;
+                compileSources();
+                linkProgram();
+            }
+        }
+        if (!fromCache)
+        {
+            if (vertexStage)
+                success &= checkCompileErrors(vertexStage, "VERTEX");
+            if (fragmentStage)
+                success &= checkCompileErrors(fragmentStage, "FRAGMENT");
+            success &= checkCompileErrors(ID, "PROGRAM");
+            if (success)
+                ProgramCache::store(ID, cacheKey);
+            // delete the shaders as they're linked into our program now and no longer necessary
+            if (vertexStage)
+                glDetachShader(ID, vertexStage);
+            if (fragmentStage)
+                glDetachShader(ID, fragmentStage);
+            glDeleteShader(vertexStage);
+            glDeleteShader(fragmentStage);
+            vertexStage = fragmentStage = 0;
+        }
+        buildUniformTable();
+        bindUniformBlock("FrameData", FRAME_DATA_BINDING);
+        bindUniformBlock("DrawData", DRAW_DATA_BINDING);
+        // drops the file mappings as well
+        vertexSource.clear();
+        fragmentSource.clear();
+        building = false;
+        return success;
+    }
+
+    // take over the linked program of another (finished) shader and delete our old one
+    // ------------------------------------------------------------------------
+    void replaceProgram(Shader& other)
+    {
+        glState().deleteProgram(ID);
+        ID = other.ID;
+        uniforms.swap(other.uniforms);
+        shadows.swap(other.shadows);
+        other.ID = 0;
+    }
+
     // utility function for checking shader compilation/linking errors.
     // ------------------------------------------------------------------------
-    void checkCompileErrors(GLuint shader, std::string type)
+    bool checkCompileErrors(GLuint shader, std::string type)
     {
         GLint success;
         GLchar infoLog[1024];
@@ -167,6 +500,7 @@ private:
                 std::cout << "ERROR::PROGRAM_LINKING_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
             }
         }
+        return success != 0;
     }
 };
 #endif
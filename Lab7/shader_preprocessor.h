@@ -0,0 +1,177 @@
+//
+//  shader_preprocessor.h
+//  3D Object Drawing
+//
+//  Small GLSL preprocessor run before sources reach the driver:
+//   - #include "file" is expanded in place (relative to the including file, each file once)
+//   - a define set such as { "FLAT_COLOR", "COUNT=4" } is injected right after #version
+//  #line directives keep driver error messages pointing at the right file and line.
+//  The result is a ShaderSource whose pieces point into the mapped (or embedded)
+//  files, so the source text itself is never copied.
+//
+
+#ifndef SHADER_PREPROCESSOR_H
+#define SHADER_PREPROCESSOR_H
+
+#include "shader_source.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+class ShaderPreprocessor
+{
+public:
+    // load path, expand its includes and inject defines; source.files receives every file that was read
+    // ------------------------------------------------------------------------
+    static bool load(const std::string& path, const std::vector<std::string>& defines, ShaderSource& source)
+    {
+        source.clear();
+        return expand(path, defines, source, true);
+    }
+
+    // canonical key of a define set: order does not matter, duplicates are dropped
+    // ------------------------------------------------------------------------
+    static std::string defineKey(std::vector<std::string> defines)
+    {
+        std::sort(defines.begin(), defines.end());
+        defines.erase(std::unique(defines.begin(), defines.end()), defines.end());
+        std::string key;
+        for (const std::string& define : defines)
+        {
+            if (!key.empty())
+                key += ';';
+            key += define;
+        }
+        return key;
+    }
+
+private:
+    static std::string directoryOf(const std::string& path)
+    {
+        size_t slash = path.find_last_of("/\\");
+        return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+    }
+
+    // "NAME=VALUE" -> "#define NAME VALUE"
+    static std::string defineLine(const std::string& define)
+    {
+        size_t equals = define.find('=');
+        if (equals == std::string::npos)
+            return "#define " + define + "\n";
+        return "#define " + define.substr(0, equals) + " " + define.substr(equals + 1) + "\n";
+    }
+
+    static const char* skipBlanks(const char* p, const char* end)
+    {
+        while (p < end && (*p == ' ' || *p == '\t'))
+            p++;
+        return p;
+    }
+
+    // true if [line, end) is a "#<directive>" line; after points past the directive name
+    static bool isDirective(const char* line, const char* end, const char* directive, const char*& after)
+    {
+        const char* p = skipBlanks(line, end);
+        if (p == end || *p != '#')
+            return false;
+        p = skipBlanks(p + 1, end);
+        size_t length = std::strlen(directive);
+        if ((size_t)(end - p) < length || std::strncmp(p, directive, length) != 0)
+            return false;
+        after = p + length;
+        return true;
+    }
+
+    // returns the quoted file name if the line is an #include directive, empty otherwise
+    static std::string includeTarget(const char* line, const char* end)
+    {
+        const char* p;
+        if (!isDirective(line, end, "include", p))
+            return std::string();
+        while (p < end && *p != '"' && *p != '<')
+            p++;
+        if (p == end)
+            return std::string();
+        const char* close = p + 1;
+        while (close < end && *close != '"' && *close != '>')
+            close++;
+        if (close == end)
+            return std::string();
+        return std::string(p + 1, close);
+    }
+
+    static bool expand(const std::string& path, const std::vector<std::string>& defines, ShaderSource& source, bool root)
+    {
+        // every file is pasted at most once, which also breaks include cycles
+        if (std::find(source.files.begin(), source.files.end(), path) != source.files.end())
+            return true;
+
+        // embedded copy first (EMBED_SHADERS builds), otherwise map the file
+        const char* data = nullptr;
+        size_t size = 0;
+        const EmbeddedShader* embedded = findEmbeddedShader(path);
+        if (embedded)
+        {
+            data = embedded->data;
+            size = embedded->size;
+        }
+        else
+        {
+            std::shared_ptr<MappedFile> mapping(new MappedFile(path));
+            if (!mapping->isValid())
+            {
+                std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << path << std::endl;
+                return false;
+            }
+            data = mapping->data();
+            size = mapping->size();
+            source.keep(mapping);
+        }
+        source.files.push_back(path);
+        const int sourceNumber = (int)source.files.size() - 1;
+
+        // untouched lines are referenced in runs; only directives we rewrite break a run
+        const char* end = data + size;
+        const char* run = data;
+        const char* line = data;
+        int lineNumber = 0;
+        while (line < end)
+        {
+            const char* newline = (const char*)std::memchr(line, '\n', end - line);
+            const char* next = newline ? newline + 1 : end;
+            lineNumber++;
+
+            std::string include = includeTarget(line, next);
+            if (!include.empty())
+            {
+                source.append(run, line - run);
+                source.appendOwned("#line 1 " + std::to_string(source.files.size()) + "\n");
+                if (!expand(directoryOf(path) + include, defines, source, false))
+                    return false;
+                source.appendOwned("#line " + std::to_string(lineNumber + 1) + " " + std::to_string(sourceNumber) + "\n");
+                run = next;
+            }
+            else if (root && end - line >= 8 && std::strncmp(line, "#version", 8) == 0)
+            {
+                source.append(run, next - run);
+                std::string injected = newline ? "" : "\n";
+                for (const std::string& define : defines)
+                    injected += defineLine(define);
+                injected += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(sourceNumber) + "\n";
+                source.appendOwned(injected);
+                run = next;
+            }
+            line = next;
+        }
+        source.append(run, end - run);
+        // an included file may end without a newline; keep the following #line on its own line
+        if (!root && size > 0 && data[size - 1] != '\n')
+            source.appendOwned("\n");
+        return true;
+    }
+};
+#endif
@@ -0,0 +1,96 @@
+//
+//  embed_shaders.cpp
+//  3D Object Drawing
+//
+//  Build step for EMBED_SHADERS builds: turns shader files into constexpr byte
+//  arrays so the program needs no shader files (and no working directory) at run time.
+//  The project runs it as a pre-build event; the header is only rewritten when
+//  its contents change, so an unchanged shader does not rebuild main.cpp.
+//
+//      embed_shaders embedded_shaders.h vertexShader.vs fragmentShader.fs
+//
+
+#include <cstdio>
+#include <cctype>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <iostream>
+
+static std::string fileName(const std::string& path)
+{
+    size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+// vertexShader.vs -> embedded_vertexShader_vs
+static std::string identifier(const std::string& name)
+{
+    std::string id = "embedded_";
+    for (char c : name)
+        id += (isalnum((unsigned char)c) ? c : '_');
+    return id;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::cout << "usage: embed_shaders <output.h> <shader file>..." << std::endl;
+        return 1;
+    }
+
+    std::ostringstream out;
+    out << "//\n//  embedded_shaders.h\n//  3D Object Drawing\n//\n//  Generated by tools/embed_shaders.cpp from:";
+    for (int i = 2; i < argc; i++)
+        out << " " << fileName(argv[i]);
+    out << "\n//  Do not edit; regenerate after changing a shader.\n//\n\n";
+    out << "#ifndef EMBEDDED_SHADERS_H\n#define EMBEDDED_SHADERS_H\n\n#include <cstddef>\n\n";
+
+    std::vector<std::string> names;
+    for (int i = 2; i < argc; i++)
+    {
+        std::ifstream in(argv[i], std::ios::binary);
+        if (!in)
+        {
+            std::cout << "ERROR::EMBED_SHADERS::FILE_NOT_SUCCESSFULLY_READ: " << argv[i] << std::endl;
+            return 1;
+        }
+        std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::string name = fileName(argv[i]);
+        names.push_back(name);
+
+        // sized explicitly so a shader may contain any byte; no terminating zero is needed
+        out << "constexpr char " << identifier(name) << "[" << (bytes.empty() ? 1 : bytes.size()) << "] = {";
+        for (size_t j = 0; j < bytes.size(); j++)
+        {
+            char hex[12];
+            std::snprintf(hex, sizeof(hex), "'\\x%02x',", (unsigned char)bytes[j]);
+            out << (j % 16 == 0 ? "\n    " : " ") << hex;
+        }
+        if (bytes.empty())
+            out << " '\\0'";
+        out << "\n};\n";
+        out << "constexpr size_t " << identifier(name) << "_size = " << bytes.size() << ";\n\n";
+    }
+
+    out << "static const EmbeddedShader embeddedShaders[] = {\n";
+    for (const std::string& name : names)
+        out << "    { \"" << name << "\", " << identifier(name) << ", " << identifier(name) << "_size },\n";
+    out << "};\nstatic const size_t embeddedShaderCount = " << names.size() << ";\n\n#endif\n";
+
+    // text mode both ways, so the header gets the platform's line endings
+    std::ifstream previous(argv[1]);
+    if (previous && std::string(std::istreambuf_iterator<char>(previous), std::istreambuf_iterator<char>()) == out.str())
+        return 0;
+    previous.close();
+    std::ofstream file(argv[1], std::ios::trunc);
+    if (!(file << out.str()))
+    {
+        std::cout << "ERROR::EMBED_SHADERS::CANNOT_WRITE: " << argv[1] << std::endl;
+        return 1;
+    }
+    return 0;
+}
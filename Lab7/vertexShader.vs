@@ -1,16 +1,56 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aColor;
+#ifdef MULTI_DRAW
+// index of this draw's DrawData entry, one per instance (see draw_commands.h)
+layout (location = 2) in uint aDrawID;
+#endif
 
 out vec4 color;
 
+// shared by every program, updated once per frame (see frame_data.h)
+layout (std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 cameraPosition;
+    float time;
+};
 
+#ifdef MULTI_DRAW
+// everything a draw of a DrawCommandBuffer used to set as uniforms
+struct Draw
+{
+    mat4 model;
+    vec4 positionScale;
+    vec4 positionBias;
+};
+layout (std140) uniform DrawData
+{
+    Draw draws[128];   // DrawCommandBuffer::MAX_DRAWS
+};
+#else
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+
+#ifdef PACKED_POSITION
+// aPos is in [-1, 1] over the mesh bounds (see vertex_format.h)
+uniform vec3 positionScale;
+uniform vec3 positionBias;
+#endif
+#endif
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0f);
+#if defined(MULTI_DRAW)
+    // float meshes carry an identity scale / bias
+    mat4 model = draws[aDrawID].model;
+    vec3 position = aPos * draws[aDrawID].positionScale.xyz + draws[aDrawID].positionBias.xyz;
+#elif defined(PACKED_POSITION)
+    vec3 position = aPos * positionScale + positionBias;
+#else
+    vec3 position = aPos;
+#endif
+    gl_Position = viewProjection * model * vec4(position, 1.0f);
     color = vec4(aColor, 1.0f);
 }
\ No newline at end of file
@@ -0,0 +1,122 @@
+//
+//  embedded_shaders.h
+//  3D Object Drawing
+//
+//  Generated by tools/embed_shaders.cpp from: vertexShader.vs fragmentShader.fs
+//  Do not edit; regenerate after changing a shader.
+//
+
+#ifndef EMBEDDED_SHADERS_H
+#define EMBEDDED_SHADERS_H
+
+#include <cstddef>
+
+constexpr char embedded_vertexShader_vs[1074] = {
+    '\x23', '\x76', '\x65', '\x72', '\x73', '\x69', '\x6f', '\x6e', '\x20', '\x33', '\x33', '\x30', '\x20', '\x63', '\x6f', '\x72',
+    '\x65', '\x0a', '\x6c', '\x61', '\x79', '\x6f', '\x75', '\x74', '\x20', '\x28', '\x6c', '\x6f', '\x63', '\x61', '\x74', '\x69',
+    '\x6f', '\x6e', '\x20', '\x3d', '\x20', '\x30', '\x29', '\x20', '\x69', '\x6e', '\x20', '\x76', '\x65', '\x63', '\x33', '\x20',
+    '\x61', '\x50', '\x6f', '\x73', '\x3b', '\x0a', '\x6c', '\x61', '\x79', '\x6f', '\x75', '\x74', '\x20', '\x28', '\x6c', '\x6f',
+    '\x63', '\x61', '\x74', '\x69', '\x6f', '\x6e', '\x20', '\x3d', '\x20', '\x31', '\x29', '\x20', '\x69', '\x6e', '\x20', '\x76',
+    '\x65', '\x63', '\x33', '\x20', '\x61', '\x43', '\x6f', '\x6c', '\x6f', '\x72', '\x3b', '\x0a', '\x23', '\x69', '\x66', '\x64',
+    '\x65', '\x66', '\x20', '\x49', '\x4e', '\x53', '\x54', '\x41', '\x4e', '\x43', '\x45', '\x44', '\x0a', '\x2f', '\x2f', '\x20',
+    '\x70', '\x65', '\x72', '\x2d', '\x69', '\x6e', '\x73', '\x74', '\x61', '\x6e', '\x63', '\x65', '\x20', '\x61', '\x74', '\x74',
+    '\x72', '\x69', '\x62', '\x75', '\x74', '\x65', '\x73', '\x20', '\x73', '\x74', '\x72', '\x65', '\x61', '\x6d', '\x65', '\x64',
+    '\x20', '\x62', '\x79', '\x20', '\x49', '\x6e', '\x73', '\x74', '\x61', '\x6e', '\x63', '\x65', '\x42', '\x61', '\x74', '\x63',
+    '\x68', '\x20', '\x28', '\x73', '\x65', '\x65', '\x20', '\x69', '\x6e', '\x73', '\x74', '\x61', '\x6e', '\x63', '\x65', '\x5f',
+    '\x62', '\x61', '\x74', '\x63', '\x68', '\x2e', '\x68', '\x29', '\x0a', '\x6c', '\x61', '\x79', '\x6f', '\x75', '\x74', '\x20',
+    '\x28', '\x6c', '\x6f', '\x63', '\x61', '\x74', '\x69', '\x6f', '\x6e', '\x20', '\x3d', '\x20', '\x32', '\x29', '\x20', '\x69',
+    '\x6e', '\x20', '\x76', '\x65', '\x63', '\x34', '\x20', '\x61', '\x49', '\x6e', '\x73', '\x74', '\x61', '\x6e', '\x63', '\x65',
+    '\x43', '\x6f', '\x6c', '\x6f', '\x72', '\x3b', '\x0a', '\x6c', '\x61', '\x79', '\x6f', '\x75', '\x74', '\x20', '\x28', '\x6c',
+    '\x6f', '\x63', '\x61', '\x74', '\x69', '\x6f', '\x6e', '\x20', '\x3d', '\x20', '\x33', '\x29', '\x20', '\x69', '\x6e', '\x20',
+    '\x6d', '\x61', '\x74', '\x34', '\x20', '\x61', '\x49', '\x6e', '\x73', '\x74', '\x61', '\x6e', '\x63', '\x65', '\x4d', '\x6f',
+    '\x64', '\x65', '\x6c', '\x3b', '\x0a', '\x23', '\x65', '\x6e', '\x64', '\x69', '\x66', '\x0a', '\x0a', '\x6f', '\x75', '\x74',
+    '\x20', '\x76', '\x65', '\x63', '\x34', '\x20', '\x63', '\x6f', '\x6c', '\x6f', '\x72', '\x3b', '\x0a', '\x0a', '\x2f', '\x2f',
+    '\x20', '\x73', '\x68', '\x61', '\x72', '\x65', '\x64', '\x20', '\x62', '\x79', '\x20', '\x65', '\x76', '\x65', '\x72', '\x79',
+    '\x20', '\x70', '\x72', '\x6f', '\x67', '\x72', '\x61', '\x6d', '\x2c', '\x20', '\x75', '\x70', '\x64', '\x61', '\x74', '\x65',
+    '\x64', '\x20', '\x6f', '\x6e', '\x63', '\x65', '\x20', '\x70', '\x65', '\x72', '\x20', '\x66', '\x72', '\x61', '\x6d', '\x65',
+    '\x20', '\x28', '\x73', '\x65', '\x65', '\x20', '\x66', '\x72', '\x61', '\x6d', '\x65', '\x5f', '\x64', '\x61', '\x74', '\x61',
+    '\x2e', '\x68', '\x29', '\x0a', '\x6c', '\x61', '\x79', '\x6f', '\x75', '\x74', '\x20', '\x28', '\x73', '\x74', '\x64', '\x31',
+    '\x34', '\x30', '\x29', '\x20', '\x75', '\x6e', '\x69', '\x66', '\x6f', '\x72', '\x6d', '\x20', '\x46', '\x72', '\x61', '\x6d',
+    '\x65', '\x44', '\x61', '\x74', '\x61', '\x0a', '\x7b', '\x0a', '\x20', '\x20', '\x20', '\x20', '\x6d', '\x61', '\x74', '\x34',
+    '\x20', '\x76', '\x69', '\x65', '\x77', '\x3b', '\x0a', '\x20', '\x20', '\x20', '\x20', '\x6d', '\x61', '\x74', '\x34', '\x20',
+    '\x70', '\x72', '\x6f', '\x6a', '\x65', '\x63', '\x74', '\x69', '\x6f', '\x6e', '\x3b', '\x0a', '\x20', '\x20', '\x20', '\x20',
+    '\x6d', '\x61', '\x74', '\x34', '\x20', '\x76', '\x69', '\x65', '\x77', '\x50', '\x72', '\x6f', '\x6a', '\x65', '\x63', '\x74',
+    '\x69', '\x6f', '\x6e', '\x3b', '\x0a', '\x20', '\x20', '\x20', '\x20', '\x76', '\x65', '\x63', '\x34', '\x20', '\x63', '\x61',
+    '\x6d', '\x65', '\x72', '\x61', '\x50', '\x6f', '\x73', '\x69', '\x74', '\x69', '\x6f', '\x6e', '\x3b', '\x0a', '\x20', '\x20',
+    '\x20', '\x20', '\x66', '\x6c', '\x6f', '\x61', '\x74', '\x20', '\x74', '\x69', '\x6d', '\x65', '\x3b', '\x0a', '\x7d', '\x3b',
+    '\x0a', '\x0a', '\x23', '\x69', '\x66', '\x6e', '\x64', '\x65', '\x66', '\x20', '\x49', '\x4e', '\x53', '\x54', '\x41', '\x4e',
+    '\x43', '\x45', '\x44', '\x0a', '\x75', '\x6e', '\x69', '\x66', '\x6f', '\x72', '\x6d', '\x20', '\x6d', '\x61', '\x74', '\x34',
+    '\x20', '\x6d', '\x6f', '\x64', '\x65', '\x6c', '\x3b', '\x0a', '\x23', '\x65', '\x6e', '\x64', '\x69', '\x66', '\x0a', '\x0a',
+    '\x23', '\x69', '\x66', '\x64', '\x65', '\x66', '\x20', '\x50', '\x41', '\x43', '\x4b', '\x45', '\x44', '\x5f', '\x50', '\x4f',
+    '\x53', '\x49', '\x54', '\x49', '\x4f', '\x4e', '\x0a', '\x2f', '\x2f', '\x20', '\x61', '\x50', '\x6f', '\x73', '\x20', '\x69',
+    '\x73', '\x20', '\x69', '\x6e', '\x20', '\x5b', '\x2d', '\x31', '\x2c', '\x20', '\x31', '\x5d', '\x20', '\x6f', '\x76', '\x65',
+    '\x72', '\x20', '\x74', '\x68', '\x65', '\x20', '\x6d', '\x65', '\x73', '\x68', '\x20', '\x62', '\x6f', '\x75', '\x6e', '\x64',
+    '\x73', '\x20', '\x28', '\x73', '\x65', '\x65', '\x20', '\x76', '\x65', '\x72', '\x74', '\x65', '\x78', '\x5f', '\x66', '\x6f',
+    '\x72', '\x6d', '\x61', '\x74', '\x2e', '\x68', '\x29', '\x0a', '\x75', '\x6e', '\x69', '\x66', '\x6f', '\x72', '\x6d', '\x20',
+    '\x76', '\x65', '\x63', '\x33', '\x20', '\x70', '\x6f', '\x73', '\x69', '\x74', '\x69', '\x6f', '\x6e', '\x53', '\x63', '\x61',
+    '\x6c', '\x65', '\x3b', '\x0a', '\x75', '\x6e', '\x69', '\x66', '\x6f', '\x72', '\x6d', '\x20', '\x76', '\x65', '\x63', '\x33',
+    '\x20', '\x70', '\x6f', '\x73', '\x69', '\x74', '\x69', '\x6f', '\x6e', '\x42', '\x69', '\x61', '\x73', '\x3b', '\x0a', '\x23',
+    '\x65', '\x6e', '\x64', '\x69', '\x66', '\x0a', '\x0a', '\x76', '\x6f', '\x69', '\x64', '\x20', '\x6d', '\x61', '\x69', '\x6e',
+    '\x28', '\x29', '\x0a', '\x7b', '\x0a', '\x23', '\x69', '\x66', '\x64', '\x65', '\x66', '\x20', '\x50', '\x41', '\x43', '\x4b',
+    '\x45', '\x44', '\x5f', '\x50', '\x4f', '\x53', '\x49', '\x54', '\x49', '\x4f', '\x4e', '\x0a', '\x20', '\x20', '\x20', '\x20',
+    '\x76', '\x65', '\x63', '\x33', '\x20', '\x70', '\x6f', '\x73', '\x69', '\x74', '\x69', '\x6f', '\x6e', '\x20', '\x3d', '\x20',
+    '\x61', '\x50', '\x6f', '\x73', '\x20', '\x2a', '\x20', '\x70', '\x6f', '\x73', '\x69', '\x74', '\x69', '\x6f', '\x6e', '\x53',
+    '\x63', '\x61', '\x6c', '\x65', '\x20', '\x2b', '\x20', '\x70', '\x6f', '\x73', '\x69', '\x74', '\x69', '\x6f', '\x6e', '\x42',
+    '\x69', '\x61', '\x73', '\x3b', '\x0a', '\x23', '\x65', '\x6c', '\x73', '\x65', '\x0a', '\x20', '\x20', '\x20', '\x20', '\x76',
+    '\x65', '\x63', '\x33', '\x20', '\x70', '\x6f', '\x73', '\x69', '\x74', '\x69', '\x6f', '\x6e', '\x20', '\x3d', '\x20', '\x61',
+    '\x50', '\x6f', '\x73', '\x3b', '\x0a', '\x23', '\x65', '\x6e', '\x64', '\x69', '\x66', '\x0a', '\x23', '\x69', '\x66', '\x64',
+    '\x65', '\x66', '\x20', '\x49', '\x4e', '\x53', '\x54', '\x41', '\x4e', '\x43', '\x45', '\x44', '\x0a', '\x20', '\x20', '\x20',
+    '\x20', '\x67', '\x6c', '\x5f', '\x50', '\x6f', '\x73', '\x69', '\x74', '\x69', '\x6f', '\x6e', '\x20', '\x3d', '\x20', '\x76',
+    '\x69', '\x65', '\x77', '\x50', '\x72', '\x6f', '\x6a', '\x65', '\x63', '\x74', '\x69', '\x6f', '\x6e', '\x20', '\x2a', '\x20',
+    '\x61', '\x49', '\x6e', '\x73', '\x74', '\x61', '\x6e', '\x63', '\x65', '\x4d', '\x6f', '\x64', '\x65', '\x6c', '\x20', '\x2a',
+    '\x20', '\x76', '\x65', '\x63', '\x34', '\x28', '\x70', '\x6f', '\x73', '\x69', '\x74', '\x69', '\x6f', '\x6e', '\x2c', '\x20',
+    '\x31', '\x2e', '\x30', '\x66', '\x29', '\x3b', '\x0a', '\x20', '\x20', '\x20', '\x20', '\x63', '\x6f', '\x6c', '\x6f', '\x72',
+    '\x20', '\x3d', '\x20', '\x61', '\x49', '\x6e', '\x73', '\x74', '\x61', '\x6e', '\x63', '\x65', '\x43', '\x6f', '\x6c', '\x6f',
+    '\x72', '\x3b', '\x0a', '\x23', '\x65', '\x6c', '\x73', '\x65', '\x0a', '\x20', '\x20', '\x20', '\x20', '\x67', '\x6c', '\x5f',
+    '\x50', '\x6f', '\x73', '\x69', '\x74', '\x69', '\x6f', '\x6e', '\x20', '\x3d', '\x20', '\x76', '\x69', '\x65', '\x77', '\x50',
+    '\x72', '\x6f', '\x6a', '\x65', '\x63', '\x74', '\x69', '\x6f', '\x6e', '\x20', '\x2a', '\x20', '\x6d', '\x6f', '\x64', '\x65',
+    '\x6c', '\x20', '\x2a', '\x20', '\x76', '\x65', '\x63', '\x34', '\x28', '\x70', '\x6f', '\x73', '\x69', '\x74', '\x69', '\x6f',
+    '\x6e', '\x2c', '\x20', '\x31', '\x2e', '\x30', '\x66', '\x29', '\x3b', '\x0a', '\x20', '\x20', '\x20', '\x20', '\x63', '\x6f',
+    '\x6c', '\x6f', '\x72', '\x20', '\x3d', '\x20', '\x76', '\x65', '\x63', '\x34', '\x28', '\x61', '\x43', '\x6f', '\x6c', '\x6f',
+    '\x72', '\x2c', '\x20', '\x31', '\x2e', '\x30', '\x66', '\x29', '\x3b', '\x0a', '\x23', '\x65', '\x6e', '\x64', '\x69', '\x66',
+    '\x0a', '\x7d',
+};
+constexpr size_t embedded_vertexShader_vs_size = 1074;
+
+constexpr char embedded_fragmentShader_fs[404] = {
+    '\x23', '\x76', '\x65', '\x72', '\x73', '\x69', '\x6f', '\x6e', '\x20', '\x33', '\x33', '\x30', '\x20', '\x63', '\x6f', '\x72',
+    '\x65', '\x0d', '\x0a', '\x0d', '\x0a', '\x2f', '\x2f', '\x20', '\x76', '\x61', '\x72', '\x69', '\x61', '\x6e', '\x74', '\x73',
+    '\x20', '\x28', '\x70', '\x69', '\x63', '\x6b', '\x20', '\x6f', '\x6e', '\x65', '\x20', '\x77', '\x69', '\x74', '\x68', '\x20',
+    '\x53', '\x68', '\x61', '\x64', '\x65', '\x72', '\x56', '\x61', '\x72', '\x69', '\x61', '\x6e', '\x74', '\x73', '\x2c', '\x20',
+    '\x6e', '\x6f', '\x20', '\x72', '\x75', '\x6e', '\x74', '\x69', '\x6d', '\x65', '\x20', '\x62', '\x72', '\x61', '\x6e', '\x63',
+    '\x68', '\x29', '\x3a', '\x0d', '\x0a', '\x2f', '\x2f', '\x20', '\x20', '\x20', '\x64', '\x65', '\x66', '\x61', '\x75', '\x6c',
+    '\x74', '\x20', '\x20', '\x20', '\x20', '\x20', '\x2d', '\x20', '\x69', '\x6e', '\x74', '\x65', '\x72', '\x70', '\x6f', '\x6c',
+    '\x61', '\x74', '\x65', '\x64', '\x20', '\x76', '\x65', '\x72', '\x74', '\x65', '\x78', '\x20', '\x63', '\x6f', '\x6c', '\x6f',
+    '\x72', '\x0d', '\x0a', '\x2f', '\x2f', '\x20', '\x20', '\x20', '\x46', '\x4c', '\x41', '\x54', '\x5f', '\x43', '\x4f', '\x4c',
+    '\x4f', '\x52', '\x20', '\x20', '\x2d', '\x20', '\x6f', '\x6e', '\x65', '\x20', '\x63', '\x6f', '\x6c', '\x6f', '\x72', '\x20',
+    '\x66', '\x6f', '\x72', '\x20', '\x74', '\x68', '\x65', '\x20', '\x77', '\x68', '\x6f', '\x6c', '\x65', '\x20', '\x64', '\x72',
+    '\x61', '\x77', '\x2c', '\x20', '\x66', '\x72', '\x6f', '\x6d', '\x20', '\x63', '\x6f', '\x6c', '\x6f', '\x72', '\x46', '\x72',
+    '\x6f', '\x6d', '\x4d', '\x61', '\x69', '\x6e', '\x0d', '\x0a', '\x0d', '\x0a', '\x69', '\x6e', '\x20', '\x76', '\x65', '\x63',
+    '\x34', '\x20', '\x63', '\x6f', '\x6c', '\x6f', '\x72', '\x3b', '\x0d', '\x0a', '\x6f', '\x75', '\x74', '\x20', '\x76', '\x65',
+    '\x63', '\x34', '\x20', '\x46', '\x72', '\x61', '\x67', '\x43', '\x6f', '\x6c', '\x6f', '\x72', '\x3b', '\x0d', '\x0a', '\x23',
+    '\x69', '\x66', '\x64', '\x65', '\x66', '\x20', '\x46', '\x4c', '\x41', '\x54', '\x5f', '\x43', '\x4f', '\x4c', '\x4f', '\x52',
+    '\x0d', '\x0a', '\x75', '\x6e', '\x69', '\x66', '\x6f', '\x72', '\x6d', '\x20', '\x76', '\x65', '\x63', '\x34', '\x20', '\x63',
+    '\x6f', '\x6c', '\x6f', '\x72', '\x46', '\x72', '\x6f', '\x6d', '\x4d', '\x61', '\x69', '\x6e', '\x3b', '\x0d', '\x0a', '\x23',
+    '\x65', '\x6e', '\x64', '\x69', '\x66', '\x0d', '\x0a', '\x0d', '\x0a', '\x76', '\x6f', '\x69', '\x64', '\x20', '\x6d', '\x61',
+    '\x69', '\x6e', '\x28', '\x29', '\x0d', '\x0a', '\x7b', '\x0d', '\x0a', '\x23', '\x69', '\x66', '\x64', '\x65', '\x66', '\x20',
+    '\x46', '\x4c', '\x41', '\x54', '\x5f', '\x43', '\x4f', '\x4c', '\x4f', '\x52', '\x0d', '\x0a', '\x20', '\x20', '\x20', '\x20',
+    '\x46', '\x72', '\x61', '\x67', '\x43', '\x6f', '\x6c', '\x6f', '\x72', '\x20', '\x3d', '\x20', '\x63', '\x6f', '\x6c', '\x6f',
+    '\x72', '\x46', '\x72', '\x6f', '\x6d', '\x4d', '\x61', '\x69', '\x6e', '\x3b', '\x0d', '\x0a', '\x23', '\x65', '\x6c', '\x73',
+    '\x65', '\x0d', '\x0a', '\x20', '\x20', '\x20', '\x20', '\x46', '\x72', '\x61', '\x67', '\x43', '\x6f', '\x6c', '\x6f', '\x72',
+    '\x20', '\x3d', '\x20', '\x63', '\x6f', '\x6c', '\x6f', '\x72', '\x3b', '\x0d', '\x0a', '\x23', '\x65', '\x6e', '\x64', '\x69',
+    '\x66', '\x0d', '\x0a', '\x7d',
+};
+constexpr size_t embedded_fragmentShader_fs_size = 404;
+
+static const EmbeddedShader embeddedShaders[] = {
+    { "vertexShader.vs", embedded_vertexShader_vs, embedded_vertexShader_vs_size },
+    { "fragmentShader.fs", embedded_fragmentShader_fs, embedded_fragmentShader_fs_size },
+};
+static const size_t embeddedShaderCount = 2;
+
+#endif
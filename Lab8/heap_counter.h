@@ -0,0 +1,73 @@
+//
+//  heap_counter.h
+//  3D Object Drawing
+//
+//  Debug builds only: replaces the global operator new to count the heap
+//  allocations made on each thread, so a hot path that must not allocate can
+//  assert on it. Replacement allocation functions may only be defined once per
+//  program: include this from main.cpp only.
+//
+//      HeapCounter::Scope noAllocations;
+//      positionScale.set(cube_position.scale);
+//      assert(noAllocations.count() == 0);
+//
+
+#ifndef HEAP_COUNTER_H
+#define HEAP_COUNTER_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+class HeapCounter
+{
+public:
+    // allocations made by the calling thread so far; always 0 in release builds
+    static size_t allocations()
+    {
+        return counter();
+    }
+
+    // allocations made by the calling thread since the scope was opened
+    class Scope
+    {
+    public:
+        Scope() : start(allocations()) {}
+        size_t count() const
+        {
+            return allocations() - start;
+        }
+
+    private:
+        size_t start;
+    };
+
+    static size_t& counter()
+    {
+        // per thread, so the shader watcher's thread does not count against the render loop
+        static thread_local size_t count = 0;
+        return count;
+    }
+};
+
+#ifndef NDEBUG
+// operator new[] and the nothrow forms forward to this one
+void* operator new(std::size_t size)
+{
+    HeapCounter::counter()++;
+    if (void* memory = std::malloc(size ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+#endif
+#endif
@@ -0,0 +1,245 @@
+//
+//  instance_batch.h
+//  3D Object Drawing
+//
+//  Many copies of one mesh drawn in a single instanced call. Each instance's
+//  model matrix and color are collected on the CPU, streamed into a
+//  StreamBuffer once per frame and read as per-instance vertex attributes
+//  (glVertexAttribDivisor 1) by vertexShader.vs built with INSTANCED.
+//
+//      batch.add(model, color);                // once per part
+//      ...
+//      batch.draw(cube_VAO, GL_TRIANGLES, 36); // once per frame, after all adds
+//
+//  With a LOD chain each instance also carries its LOD (mesh_lod.h), and
+//  drawLODs() sorts the instances by it into one upload and issues one
+//  instanced draw per LOD in use, over that LOD's range of the index buffer.
+//  An instance can also be limited to some runs of its LOD, the meshlets that
+//  survived culling (meshlet_culling.h); those instances are uploaded after the
+//  groups and each draws its runs with one glMultiDrawElements.
+//
+
+#ifndef INSTANCE_BATCH_H
+#define INSTANCE_BATCH_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "gl_state.h"
+#include "stream_buffer.h"
+#include "mesh_file.h"
+
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <iostream>
+
+// one instance as the shader reads it; the layout matches the attribute pointers below
+struct Instance
+{
+    glm::vec4 color;
+    glm::mat4 model;
+};
+
+class InstanceBatch
+{
+public:
+    // attribute locations in vertexShader.vs; the mat4 takes four consecutive ones
+    static const GLuint COLOR_ATTRIBUTE = 2;
+    static const GLuint MODEL_ATTRIBUTE = 3;
+
+    explicit InstanceBatch(size_t maxInstances) : stream(maxInstances * sizeof(Instance)), pointedVAO(0), pointedOffset(-1)
+    {
+        instances.reserve(maxInstances);
+        instanceDraws.reserve(maxInstances);
+    }
+
+    InstanceBatch(const InstanceBatch&) = delete;
+    InstanceBatch& operator=(const InstanceBatch&) = delete;
+
+    // lod and runs only matter to drawLODs(); without runs the instance draws its whole LOD
+    void add(const glm::mat4& model, const glm::vec4& color, unsigned int lod = 0, const IndexRange* runs = nullptr, size_t runCount = 0)
+    {
+        Instance instance;
+        instance.color = color;
+        instance.model = model;
+        instances.push_back(instance);
+        InstanceDraw draw;
+        draw.lod = lod;
+        draw.firstRun = (uint32_t)instanceRuns.size();
+        draw.runCount = (uint32_t)runCount;
+        instanceDraws.push_back(draw);
+        instanceRuns.insert(instanceRuns.end(), runs, runs + runCount);
+    }
+
+    size_t size() const
+    {
+        return instances.size();
+    }
+
+    // upload the instances added since the last draw and draw count indices of vao for each;
+    // call once per frame, the stream moves to its next region on every call
+    // ------------------------------------------------------------------------
+    void draw(GLuint vao, GLenum mode, GLsizei count, GLenum type = GL_UNSIGNED_INT, const void* indices = 0)
+    {
+        GLintptr offset;
+        Instance* data = allocate(offset);
+        if (!data)
+            return;
+        std::memcpy(data, instances.data(), instances.size() * sizeof(Instance));
+        stream.flush();
+
+        glState().bindVertexArray(vao);
+        // the ring hands out a new region each frame, so the pointers follow it
+        if (vao != pointedVAO || offset != pointedOffset)
+            pointAttributes(vao, offset);
+        glDrawElementsInstanced(mode, count, type, indices, (GLsizei)instances.size());
+        clearInstances();
+    }
+
+    // like draw(), with each instance drawing the index range of the LOD it was added with, or
+    // its runs of it; the instances are grouped by LOD in the upload and each group is one
+    // instanced draw, followed by one multi-draw per instance with runs of its own
+    // ------------------------------------------------------------------------
+    void drawLODs(GLuint vao, GLenum mode, GLenum type, const MeshLOD* lods, size_t lodCount)
+    {
+        GLintptr offset;
+        Instance* data = allocate(offset);
+        if (!data)
+            return;
+        if (lodCount == 0)
+        {
+            clearInstances();
+            return;
+        }
+
+        // counting sort by LOD, straight into the stream; group lodCount is the instances with runs
+        groupStart.assign(lodCount + 2, 0);
+        for (size_t i = 0; i < instances.size(); i++)
+            groupStart[groupOf(i, lods, lodCount) + 1]++;
+        for (size_t group = 0; group <= lodCount; group++)
+            groupStart[group + 1] += groupStart[group];
+        groupEnd.assign(groupStart.begin(), groupStart.end() - 1);
+        partial.clear();
+        for (size_t i = 0; i < instances.size(); i++)
+        {
+            size_t group = groupOf(i, lods, lodCount);
+            if (group == lodCount)
+                partial.push_back(i);
+            data[groupEnd[group]++] = instances[i];
+        }
+        stream.flush();
+
+        glState().bindVertexArray(vao);
+        for (size_t lod = 0; lod < lodCount; lod++)
+        {
+            GLsizei count = (GLsizei)(groupStart[lod + 1] - groupStart[lod]);
+            if (count == 0)
+                continue;
+            // GL 3.3 has no base instance, so the attributes are pointed at the group instead
+            GLintptr groupOffset = offset + (GLintptr)(groupStart[lod] * sizeof(Instance));
+            if (vao != pointedVAO || groupOffset != pointedOffset)
+                pointAttributes(vao, groupOffset);
+            glDrawElementsInstanced(mode, (GLsizei)lods[lod].indexCount, type,
+                (void*)(uintptr_t)(lods[lod].firstIndex * indexSize(type)), count);
+        }
+        // a non-instanced draw reads instance 0 of the divisor 1 attributes, so each points at its own
+        for (size_t p = 0; p < partial.size(); p++)
+        {
+            const InstanceDraw& draw = instanceDraws[partial[p]];
+            runCounts.clear();
+            runStarts.clear();
+            for (uint32_t run = draw.firstRun; run < draw.firstRun + draw.runCount; run++)
+            {
+                runCounts.push_back((GLsizei)instanceRuns[run].indexCount);
+                runStarts.push_back((const void*)(uintptr_t)(instanceRuns[run].firstIndex * indexSize(type)));
+            }
+            pointAttributes(vao, offset + (GLintptr)((groupStart[lodCount] + p) * sizeof(Instance)));
+            glMultiDrawElements(mode, runCounts.data(), type, runStarts.data(), (GLsizei)runCounts.size());
+        }
+        clearInstances();
+    }
+
+    // delete the GL objects; call while the context is still current
+    // ------------------------------------------------------------------------
+    void clear()
+    {
+        stream.clear();
+        clearInstances();
+    }
+
+private:
+    StreamBuffer stream;
+    std::vector<Instance> instances;
+    // what each instance draws, its runs in instanceRuns
+    struct InstanceDraw
+    {
+        unsigned int lod;
+        uint32_t firstRun;
+        uint32_t runCount;
+    };
+    std::vector<InstanceDraw> instanceDraws;
+    std::vector<IndexRange> instanceRuns;
+    // per-LOD ranges of the upload and the multi-draw arguments, kept to avoid reallocating every frame
+    std::vector<size_t> groupStart, groupEnd, partial;
+    std::vector<GLsizei> runCounts;
+    std::vector<const void*> runStarts;
+    GLuint pointedVAO;
+    GLintptr pointedOffset;
+
+    // this frame's region of the stream for every added instance, or nullptr with nothing to draw
+    Instance* allocate(GLintptr& offset)
+    {
+        stream.nextFrame();
+        if (instances.empty())
+            return nullptr;
+        Instance* data = stream.allocate<Instance>(instances.size(), offset);
+        if (!data)
+        {
+            std::cout << "ERROR::INSTANCE_BATCH::TOO_MANY_INSTANCES " << instances.size() << std::endl;
+            clearInstances();
+        }
+        return data;
+    }
+
+    void clearInstances()
+    {
+        instances.clear();
+        instanceDraws.clear();
+        instanceRuns.clear();
+    }
+
+    // LOD group of instance i, or lodCount when it only draws some runs of its LOD
+    size_t groupOf(size_t i, const MeshLOD* lods, size_t lodCount) const
+    {
+        const InstanceDraw& draw = instanceDraws[i];
+        size_t lod = std::min<size_t>(draw.lod, lodCount - 1);
+        if (draw.runCount == 0)
+            return lod;
+        // everything survived: one run over the whole LOD is the group's draw
+        const IndexRange& run = instanceRuns[draw.firstRun];
+        if (draw.runCount == 1 && run.firstIndex == lods[lod].firstIndex && run.indexCount == lods[lod].indexCount)
+            return lod;
+        return lodCount;
+    }
+
+    // per-instance attributes of the bound vao, read from the stream at offset
+    void pointAttributes(GLuint vao, GLintptr offset)
+    {
+        glState().bindBuffer(GL_ARRAY_BUFFER, stream.getBuffer());
+        glVertexAttribPointer(COLOR_ATTRIBUTE, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)offset);
+        glEnableVertexAttribArray(COLOR_ATTRIBUTE);
+        glVertexAttribDivisor(COLOR_ATTRIBUTE, 1);
+        for (GLuint column = 0; column < 4; column++)
+        {
+            GLintptr columnOffset = offset + sizeof(glm::vec4) * (1 + column);
+            glVertexAttribPointer(MODEL_ATTRIBUTE + column, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)columnOffset);
+            glEnableVertexAttribArray(MODEL_ATTRIBUTE + column);
+            glVertexAttribDivisor(MODEL_ATTRIBUTE + column, 1);
+        }
+        pointedVAO = vao;
+        pointedOffset = offset;
+    }
+};
+#endif
@@ -1,13 +1,25 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <iostream>
+#include <cassert>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
-#include "shader.h"
+#include "gl_ext.h"
+#include "gl_state.h"
+#include "shader_builder.h"
+#include "shader_pipeline.h"
+#include "shader_watcher.h"
+#include "uniform.h"
 #include "camera.h"
-#include "shader.h"
+#include "frame_data.h"
+#include "vertex_format.h"
+#include "instance_batch.h"
+#include "mesh_file.h"
+#include "mesh_lod.h"
+#include "meshlet_culling.h"
+#include "heap_counter.h"
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void mouse_callback(GLFWwindow* window, double xpos, double ypos);
@@ -82,13 +94,37 @@ int main()
         std::cout << "Failed to initialize GLAD" << std::endl;
         return -1;
     }
+    // load the GL 4.x / ARB entry points that the 3.3 glad loader does not provide
+    loadGLExtensions((GLADloadproc)glfwGetProcAddress);
 
 
-    glEnable(GL_DEPTH_TEST);
+    glState().enable(GL_DEPTH_TEST);
+
+    // the cube, converted offline from cube.txt by tools/mesh_convert.cpp: already reordered,
+    // packed and narrowed, so loading is a mapping and a header check
+    double loadStart = glfwGetTime();
+    MeshFile cubeMesh("cube.mesh");
+    if (!cubeMesh.isValid())
+    {
+        glfwTerminate();
+        return -1;
+    }
+    std::cout << "CUBE: mapped " << cubeMesh.size() << " bytes in " << (glfwGetTime() - loadStart) * 1000.0 << " ms" << std::endl;
 
     // build and compile our shader program
     // ------------------------------------
-    Shader ourShader("vertexShader.vs", "fragmentShader.fs");
+    // submitted now, resolved after the buffers are set up so the driver compiles in the meantime
+    // every part of the fan is a cube instance with its own model matrix and flat color, so only the
+    // INSTANCED vertex variant is needed, plus the position decode of the packed cube vertices; the
+    // fragment stage has no defines and is shared by whatever other vertex variants get added
+    const VertexFormat cubeFormat = cubeMesh.format();
+    std::vector<std::string> cubeDefines = vertexFormatDefines(cubeFormat);
+    cubeDefines.push_back("INSTANCED");
+    ShaderStages shaderStages;
+    ShaderBuilder shaderBuilder;
+    shaderStages.prepare(shaderBuilder, GL_VERTEX_SHADER, "vertexShader.vs", cubeDefines);
+    shaderStages.prepare(shaderBuilder, GL_FRAGMENT_SHADER, "fragmentShader.fs", std::vector<std::string>());
+    shaderBuilder.submit();
 
     // set up vertex data (and buffer(s)) and configure vertex attributes
     // ------------------------------------------------------------------
@@ -98,97 +134,102 @@ int main()
 
     //----------------------------------------------------------------------------Cube
 
-    float cube_vertices[] = {
-        0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
-        0.5f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
-        0.5f, 0.5f, 0.0f, 1.0f, 0.0f, 0.0f,
-        0.0f, 0.5f, 0.0f, 1.0f, 0.0f, 0.0f,
-
-        0.5f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f,
-        0.5f, 0.5f, 0.0f, 0.0f, 1.0f, 0.0f,
-        0.5f, 0.0f, 0.5f, 0.0f, 1.0f, 0.0f,
-        0.5f, 0.5f, 0.5f, 0.0f, 1.0f, 0.0f,
-
-        0.0f, 0.0f, 0.5f, 0.0f, 0.0f, 1.0f,
-        0.5f, 0.0f, 0.5f, 0.0f, 0.0f, 1.0f,
-        0.5f, 0.5f, 0.5f, 0.0f, 0.0f, 1.0f,
-        0.0f, 0.5f, 0.5f, 0.0f, 0.0f, 1.0f,
-
-        0.0f, 0.0f, 0.5f, 1.0f, 1.0f, 0.0f,
-        0.0f, 0.5f, 0.5f, 1.0f, 1.0f, 0.0f,
-        0.0f, 0.5f, 0.0f, 1.0f, 1.0f, 0.0f,
-        0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f,
-
-        0.5f, 0.5f, 0.5f, 0.0f, 1.0f, 1.0f,
-        0.5f, 0.5f, 0.0f, 0.0f, 1.0f, 1.0f,
-        0.0f, 0.5f, 0.0f, 0.0f, 1.0f, 1.0f,
-        0.0f, 0.5f, 0.5f, 0.0f, 1.0f, 1.0f,
-
-        0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f,
-        0.5f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f,
-        0.5f, 0.0f, 0.5f, 1.0f, 0.0f, 1.0f,
-        0.0f, 0.0f, 0.5f, 1.0f, 0.0f, 1.0f
-    };
-    unsigned int cube_indices[] = {
-        0, 3, 2,
-        2, 1, 0,
-
-        4, 5, 7,
-        7, 6, 4,
-
-        8, 9, 10,
-        10, 11, 8,
-
-        12, 13, 14,
-        14, 15, 12,
-
-        16, 17, 18,
-        18, 19, 16,
-
-        20, 21, 22,
-        22, 23, 20
-    };
+    const PositionTransform cube_position = cubeMesh.positionTransform();
+    const GLenum cube_index_type = cubeMesh.indexType();
 
     unsigned int cube_VAO, cube_VBO, cube_EBO;
     glGenVertexArrays(1, &cube_VAO);
     glGenBuffers(1, &cube_VBO);
     glGenBuffers(1, &cube_EBO);
 
-    glBindVertexArray(cube_VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, cube_VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(cube_vertices), cube_vertices, GL_STATIC_DRAW);
+    glState().bindVertexArray(cube_VAO);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cube_EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(cube_indices), cube_indices, GL_STATIC_DRAW);
+    glState().bindBuffer(GL_ARRAY_BUFFER, cube_VBO);
+    // straight from the mapping
+    glBufferData(GL_ARRAY_BUFFER, cubeMesh.header().vertexBytes, cubeMesh.vertexData(), GL_STATIC_DRAW);
 
-    // position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
+    glState().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, cube_EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, cubeMesh.header().indexBytes, cubeMesh.indexData(), GL_STATIC_DRAW);
 
-    //color attribute
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)12);
-    glEnableVertexAttribArray(1);
+    // position and color attributes, as described in the file
+    cubeMesh.vertexAttributes();
 
 
     //Enabling opacity changing capability
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glState().enable(GL_BLEND);
+    glState().blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+
+    Shader& cubeVertex = shaderStages.get(GL_VERTEX_SHADER, "vertexShader.vs", cubeDefines);
+    Shader& sharedFragment = shaderStages.get(GL_FRAGMENT_SHADER, "fragmentShader.fs");
+    ProgramPipeline& cubePipeline = shaderStages.pipeline(cubeVertex, sharedFragment);
+    // resolved once; the render loop sets them without any name lookups or string temporaries
+    Uniform<glm::vec3> positionScale(cubePipeline.program(GL_VERTEX_SHADER), "positionScale");
+    Uniform<glm::vec3> positionBias(cubePipeline.program(GL_VERTEX_SHADER), "positionBias");
+
+    // every cube of the scene, drawn with one glDrawElementsInstanced per LOD in use each frame
+    InstanceBatch cubeInstances(64);
+    // each part picks the LOD of the chain in cube.mesh that is within a pixel at its distance;
+    // all of them index cube_VBO and live in cube_EBO, so switching is only another index range
+    LODSelector cubeLODs(cubeMesh);
+    // then drops the meshlets of that LOD the camera cannot see; a part with nothing left is not
+    // drawn at all, one with everything left joins its LOD's instanced draw (every cube LOD is a
+    // single meshlet, so here this is frustum culling of whole parts)
+    MeshletCuller cubeCuller;
+    std::vector<IndexRange> cubeRuns;
+    auto addCube = [&](const glm::mat4& model, const glm::vec4& color)
+    {
+        unsigned int lod = cubeLODs.select(model);
+        if (cubeCuller.cull(model, cubeMesh, lod, cubeRuns))
+            cubeInstances.add(model, color, lod, cubeRuns.data(), cubeRuns.size());
+    };
+
+    // per-frame camera uniforms shared by every program
+    FrameUniforms frameUniforms;
 
+    // rebuild the stages in the background whenever the shader files are saved; on plain 3.3 the
+    // pipeline's own combined program is what gets rebuilt
+    ShaderWatcher shaderWatcher;
+    if (Shader* combined = cubePipeline.combinedProgram())
+        shaderWatcher.watch(*combined, "vertexShader.vs", "fragmentShader.fs");
+    else
+    {
+        shaderWatcher.watch(cubeVertex, "vertexShader.vs");
+        shaderWatcher.watch(sharedFragment, "fragmentShader.fs");
+    }
 
     // uncomment this call to draw in wireframe polygons.
     //glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
+    // when the last frame's uniform and state counters were printed
+    float lastStatsTime = 0.0f;
+
     // render loop
     // -----------
     while (!glfwWindowShouldClose(window))
     {
 
+        // swap in any shader that finished rebuilding since the last frame
+        shaderWatcher.update();
+        // roll the uniform issued/elided counters over to Shader::lastFrameUniformStats()
+        Shader::beginFrame();
+        // and the state-change counters to GLStateCache::lastFrameStats()
+        GLStateCache::beginFrame();
+
         // per-frame time logic
         // --------------------
         float currentFrame = static_cast<float>(glfwGetTime());
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
+        // once a second, how many glUniform* and state calls the shadow copies saved last frame
+        if (currentFrame - lastStatsTime >= 1.0f)
+        {
+            lastStatsTime = currentFrame;
+            const Shader::UniformStats& uniforms = Shader::lastFrameUniformStats();
+            const GLStateCache::Stats& state = GLStateCache::lastFrameStats();
+            std::cout << "UNIFORMS: " << uniforms.issued << " issued, " << uniforms.elided << " elided last frame" << std::endl;
+            std::cout << "GL_STATE: " << state.issued << " issued, " << state.elided << " elided last frame" << std::endl;
+        }
         // input
         // -----
         processInput(window);
@@ -201,16 +242,19 @@ int main()
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         // draw our first triangle
-        ourShader.use();
-
+        cubePipeline.bind();
+        cubePipeline.activate(GL_VERTEX_SHADER);
+        // the per-frame uniform updates must not touch the heap; checked in debug builds
+        HeapCounter::Scope uniformAllocations;
+        // every cube shares one packed vertex range; shadowed, so only a reloaded program sees these again
+        positionScale.set(cube_position.scale);
+        positionBias.set(cube_position.bias);
 
-        // pass projection matrix to shader (note that in this case it could change every frame)
-        glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
-        //glm::mat4 projection = glm::ortho(-2.0f, +2.0f, -1.5f, +1.5f, 0.1f, 100.0f);
-        ourShader.setMat4("projection", projection);
-        // camera/view transformation
-        glm::mat4 view = camera.GetViewMatrix();
-        ourShader.setMat4("view", view);
+        // camera/view and projection go to every program at once through the FrameData block
+        frameUniforms.update(camera, (float)SCR_WIDTH / (float)SCR_HEIGHT, currentFrame);
+        assert(uniformAllocations.count() == 0);
+        cubeLODs.setView(camera, (float)SCR_HEIGHT);
+        cubeCuller.setView(frameUniforms.data);
 
 
 
@@ -243,71 +287,31 @@ int main()
 
         //-----------------------------------------------------------------------------------------Center
         model = translateWholeFan * translateToPivot * rotateZMatrix * translateToCenter;
-        ourShader.setMat4("model", model);
-
-        glm::vec4 newColor = glm::vec4(0.4f, 0.4f, 0.4f, 1.0f);
-        ourShader.setBool("changeColorFromMain", true);
-        ourShader.setVec4("colorFromMain", newColor);
-        glBindVertexArray(cube_VAO);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+        addCube(model, glm::vec4(0.4f, 0.4f, 0.4f, 1.0f));
         
-        ourShader.setBool("changeColorFromMain", false);
-
         //-----------------------------------------------------------------------------------------Right Hand
         translateMatrix = glm::translate(identityMatrix, glm::vec3(0.25f, 0.1f, 0.1f));
         scaleMatrix = glm::scale(identityMatrix, glm::vec3(2.5f, 0.6f, 0.6f));
         model = translateWholeFan * translateToPivot * rotateZMatrix * translateToCenter * translateMatrix * scaleMatrix;
-        ourShader.setMat4("model", model);
-
-        newColor = glm::vec4(0.7f, 0.8f, 0.9f, 1.0f);
-        ourShader.setBool("changeColorFromMain", true);
-        ourShader.setVec4("colorFromMain", newColor);
-        glBindVertexArray(cube_VAO);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-
-        ourShader.setBool("changeColorFromMain", false);
+        addCube(model, glm::vec4(0.7f, 0.8f, 0.9f, 1.0f));
 
         //-----------------------------------------------------------------------------------------Left Hand
         translateMatrix = glm::translate(identityMatrix, glm::vec3(-1.0f, 0.1f, 0.1f));
         scaleMatrix = glm::scale(identityMatrix, glm::vec3(2.5f, 0.6f, 0.6f));
         model = translateWholeFan * translateToPivot * rotateZMatrix * translateToCenter * translateMatrix * scaleMatrix;
-        ourShader.setMat4("model", model);
-
-        newColor = glm::vec4(0.7f, 0.8f, 0.9f, 1.0f);
-        ourShader.setBool("changeColorFromMain", true);
-        ourShader.setVec4("colorFromMain", newColor);
-        glBindVertexArray(cube_VAO);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-
-        ourShader.setBool("changeColorFromMain", false);
+        addCube(model, glm::vec4(0.7f, 0.8f, 0.9f, 1.0f));
 
         //-----------------------------------------------------------------------------------------Upper Hand
         translateMatrix = glm::translate(identityMatrix, glm::vec3(0.12f, 0.25f, 0.1f));
         scaleMatrix = glm::scale(identityMatrix, glm::vec3(0.6f, 2.5f, 0.6f));
         model = translateWholeFan * translateToPivot * rotateZMatrix * translateToCenter * translateMatrix * scaleMatrix;
-        ourShader.setMat4("model", model);
-
-        newColor = glm::vec4(0.7f, 0.8f, 0.9f, 1.0f);
-        ourShader.setBool("changeColorFromMain", true);
-        ourShader.setVec4("colorFromMain", newColor);
-        glBindVertexArray(cube_VAO);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-
-        ourShader.setBool("changeColorFromMain", false);
+        addCube(model, glm::vec4(0.7f, 0.8f, 0.9f, 1.0f));
 
         //-----------------------------------------------------------------------------------------Bottom Hand
         translateMatrix = glm::translate(identityMatrix, glm::vec3(0.12f, -1.0f, 0.1f));
         scaleMatrix = glm::scale(identityMatrix, glm::vec3(0.6f, 2.5f, 0.6f));
         model = translateWholeFan * translateToPivot * rotateZMatrix * translateToCenter * translateMatrix * scaleMatrix;
-        ourShader.setMat4("model", model);
-
-        newColor = glm::vec4(0.7f, 0.8f, 0.9f, 1.0f);
-        ourShader.setBool("changeColorFromMain", true);
-        ourShader.setVec4("colorFromMain", newColor);
-        glBindVertexArray(cube_VAO);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-
-        ourShader.setBool("changeColorFromMain", false);
+        addCube(model, glm::vec4(0.7f, 0.8f, 0.9f, 1.0f));
 
 
         //----------------------------------------------------------------------------------------Stand
@@ -316,43 +320,19 @@ int main()
         translateMatrix = glm::translate(identityMatrix, glm::vec3(0.2f, -1.6f, -0.4f));
         scaleMatrix = glm::scale(identityMatrix, glm::vec3(0.3f, 4.0f, 0.3f));
         model = translateWholeFan * translateMatrix * scaleMatrix;
-        ourShader.setMat4("model", model);
-
-        newColor = glm::vec4(0.4f, 0.4f, 0.4f, 1.0f);
-        ourShader.setBool("changeColorFromMain", true);
-        ourShader.setVec4("colorFromMain", newColor);
-        glBindVertexArray(cube_VAO);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-
-        ourShader.setBool("changeColorFromMain", false);
+        addCube(model, glm::vec4(0.4f, 0.4f, 0.4f, 1.0f));
 
         //b
         translateMatrix = glm::translate(identityMatrix, glm::vec3(0.2f, 0.2f, -0.4f));
         scaleMatrix = glm::scale(identityMatrix, glm::vec3(0.3f, 0.3f, 1.0f));
         model = translateWholeFan * translateMatrix * scaleMatrix;
-        ourShader.setMat4("model", model);
-
-        newColor = glm::vec4(0.4f, 0.4f, 0.4, 1.0f);
-        ourShader.setBool("changeColorFromMain", true);
-        ourShader.setVec4("colorFromMain", newColor);
-        glBindVertexArray(cube_VAO);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-
-        ourShader.setBool("changeColorFromMain", false);
+        addCube(model, glm::vec4(0.4f, 0.4f, 0.4, 1.0f));
 
         //c
         translateMatrix = glm::translate(identityMatrix, glm::vec3(-0.7, -1.6f, -1.0f));
         scaleMatrix = glm::scale(identityMatrix, glm::vec3(4.0f, 0.2f, 3.0f));
         model = translateWholeFan * translateMatrix * scaleMatrix;
-        ourShader.setMat4("model", model);
-
-        newColor = glm::vec4(0.9f, 0.8f, 0.7f, 1.0f);
-        ourShader.setBool("changeColorFromMain", true);
-        ourShader.setVec4("colorFromMain", newColor);
-        glBindVertexArray(cube_VAO);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-
-        ourShader.setBool("changeColorFromMain", false);
+        addCube(model, glm::vec4(0.9f, 0.8f, 0.7f, 1.0f));
 
 
         //---------------------------------------------------------------------------------Ceiling Fan
@@ -371,16 +351,7 @@ int main()
         translateMatrix = glm::translate(identityMatrix, glm::vec3(0.12f, 2.0f, 3.0f));
         scaleMatrix = glm::scale(identityMatrix, glm::vec3(0.2f, 0.6f, 0.2f));
         model = translateWholeFan * translateMatrix * scaleMatrix;
-       
-        ourShader.setMat4("model", model);
-
-        newColor = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
-        ourShader.setBool("changeColorFromMain", true);
-        ourShader.setVec4("colorFromMain", newColor);
-        glBindVertexArray(cube_VAO);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-
-        ourShader.setBool("changeColorFromMain", false);
+        addCube(model, glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
 
 
         //------------------------------------------------------------------------------------------- Center Cube
@@ -388,43 +359,19 @@ int main()
         translateMatrix = glm::translate(identityMatrix, glm::vec3(-0.09, 1.6f, 2.8f));
         scaleMatrix = glm::scale(identityMatrix, glm::vec3(1.0f, 0.6f, 1.0f));
         model = translateWholeFan * translateToPivot * rotateYMatrix * translateToCenter * translateMatrix * scaleMatrix;
-        ourShader.setMat4("model", model);
-
-        newColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
-        ourShader.setBool("changeColorFromMain", true);
-        ourShader.setVec4("colorFromMain", newColor);
-        glBindVertexArray(cube_VAO);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-
-        ourShader.setBool("changeColorFromMain", false);
+        addCube(model, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
 
         //--------------------------------------------------------------------------------------------------------------Left Blade
         translateMatrix = glm::translate(identityMatrix, glm::vec3(-1.0f, 1.7f, 2.9f));
         scaleMatrix = glm::scale(identityMatrix, glm::vec3(2.5f, 0.2f, 0.6f));
         model = translateWholeFan * translateToPivot * rotateYMatrix * translateToCenter * translateMatrix * scaleMatrix;
-        ourShader.setMat4("model", model);
-
-        newColor = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
-        ourShader.setBool("changeColorFromMain", true);
-        ourShader.setVec4("colorFromMain", newColor);
-        glBindVertexArray(cube_VAO);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-
-        ourShader.setBool("changeColorFromMain", false);
+        addCube(model, glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
 
         //--------------------------------------------------------------------------------------------------------------Right Blade
         translateMatrix = glm::translate(identityMatrix, glm::vec3(0.1f, 1.7f, 2.9f));
         scaleMatrix = glm::scale(identityMatrix, glm::vec3(2.5f, 0.2f, 0.6f));
         model = translateWholeFan * translateToPivot * rotateYMatrix * translateToCenter * translateMatrix * scaleMatrix;
-        ourShader.setMat4("model", model);
-
-        newColor = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
-        ourShader.setBool("changeColorFromMain", true);
-        ourShader.setVec4("colorFromMain", newColor);
-        glBindVertexArray(cube_VAO);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-
-        ourShader.setBool("changeColorFromMain", false);
+        addCube(model, glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
 
 
         //--------------------------------------------------------------------------------------------------------------Back Blade
@@ -434,15 +381,7 @@ int main()
         rotateBladeMatrix = glm::rotate(identityMatrix, glm::radians(cube_blade_back), glm::vec3(0.0f, 1.0f, 0.0f));
 
         model = translateWholeFan * translateToPivot * rotateYMatrix * translateToCenter  * translateMatrix * rotateBladeMatrix * scaleMatrix ;
-        ourShader.setMat4("model", model);
-
-        newColor = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
-        ourShader.setBool("changeColorFromMain", true);
-        ourShader.setVec4("colorFromMain", newColor);
-        glBindVertexArray(cube_VAO);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-
-        ourShader.setBool("changeColorFromMain", false);
+        addCube(model, glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
 
         //--------------------------------------------------------------------------------------------------------------Front Blade
         translateMatrix = glm::translate(identityMatrix, glm::vec3(0.32f, 1.7f, 2.9f));
@@ -451,16 +390,11 @@ int main()
         rotateBladeMatrix = glm::rotate(identityMatrix, glm::radians(cube_blade_front), glm::vec3(0.0f, 1.0f, 0.0f));
 
         model = translateWholeFan * translateToPivot * rotateYMatrix * translateToCenter * translateMatrix * rotateBladeMatrix * scaleMatrix;
-        ourShader.setMat4("model", model);
-
-        newColor = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
-        ourShader.setBool("changeColorFromMain", true);
-        ourShader.setVec4("colorFromMain", newColor);
-        glBindVertexArray(cube_VAO);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+        addCube(model, glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
 
-        ourShader.setBool("changeColorFromMain", false);
 
+        // all visible parts, one draw per LOD they use
+        cubeInstances.drawLODs(cube_VAO, GL_TRIANGLES, cube_index_type, cubeLODs.getLODs(), cubeLODs.getLODCount());
 
         // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
         // -------------------------------------------------------------------------------
@@ -470,8 +404,12 @@ int main()
 
     // optional: de-allocate all resources once they've outlived their purpose:
     // ------------------------------------------------------------------------
-    glDeleteVertexArrays(1, &cube_VAO);
-    glDeleteBuffers(1, &cube_VAO);
+    glState().deleteVertexArray(cube_VAO);
+    glState().deleteBuffer(cube_VBO);
+    glState().deleteBuffer(cube_EBO);
+    cubeInstances.clear();
+
+    shaderWatcher.clear();
 
     // glfw: terminate, clearing all previously allocated GLFW resources.
     // ------------------------------------------------------------------
@@ -538,7 +476,7 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
     // make sure the viewport matches the new window dimensions; note that width and 
     // height will be significantly larger than specified on retina displays.
-    glViewport(0, 0, width, height);
+    glState().viewport(0, 0, width, height);
 }
 
 void mouse_callback(GLFWwindow* window, double xposIn, double yposIn)
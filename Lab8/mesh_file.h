@@ -0,0 +1,316 @@
+//
+//  mesh_file.h
+//  3D Object Drawing
+//
+//  Binary mesh container, written offline by tools/mesh_convert.cpp and used
+//  in place at run time: MeshFile maps the file, checks the header and hands
+//  out pointers straight into the mapping, so glBufferData uploads from the
+//  page cache with no parsing and no intermediate copy.
+//
+//      MeshFile cube("cube.mesh");
+//      glBufferData(GL_ARRAY_BUFFER, cube.header().vertexBytes, cube.vertexData(), GL_STATIC_DRAW);
+//      glBufferData(GL_ELEMENT_ARRAY_BUFFER, cube.header().indexBytes, cube.indexData(), GL_STATIC_DRAW);
+//      cube.vertexAttributes();
+//
+//  Layout (little endian):
+//      MeshFileHeader
+//      MeshAttribute[attributeCount]   how the vertex blob is read, glVertexAttribPointer-style
+//      MeshLOD[lodCount]               index ranges, most detailed first
+//      Meshlet[meshletCount]           clusters of each LOD's range, see meshlet_builder.h
+//      vertex blob                     at a MESH_FILE_ALIGNMENT boundary
+//      index blob                      at a MESH_FILE_ALIGNMENT boundary
+//  Any change to the layout bumps MESH_FILE_VERSION; older files are rejected.
+//
+
+#ifndef MESH_FILE_H
+#define MESH_FILE_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "mapped_file.h"
+#include "vertex_format.h"
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <cstdint>
+
+const uint32_t MESH_FILE_VERSION = 2;
+// blobs start on page boundaries so each one maps, and pages in, on its own
+const uint64_t MESH_FILE_ALIGNMENT = 4096;
+
+struct MeshFileHeader
+{
+    char magic[4];              // "MESH"
+    uint32_t version;           // MESH_FILE_VERSION
+    uint32_t vertexFormat;      // VertexFormat
+    uint32_t vertexStride;      // bytes
+    uint32_t vertexCount;
+    uint32_t indexType;         // GL_UNSIGNED_BYTE / SHORT / INT
+    uint32_t indexCount;        // of every LOD together
+    uint32_t attributeCount;
+    uint32_t lodCount;
+    uint32_t meshletCount;      // 0 when converted without --meshlets
+    float boundsMin[3];         // of the decoded positions
+    float boundsMax[3];
+    float positionScale[3];     // decode of packed positions, see PositionTransform
+    float positionBias[3];
+    uint64_t vertexOffset;      // from the start of the file
+    uint64_t vertexBytes;
+    uint64_t indexOffset;
+    uint64_t indexBytes;
+};
+static_assert(sizeof(MeshFileHeader) == 120, "the header has no padding");
+
+struct MeshAttribute
+{
+    uint32_t location;
+    uint32_t components;
+    uint32_t type;              // GL_FLOAT, GL_HALF_FLOAT, GL_SHORT, ...
+    uint32_t normalized;
+    uint32_t offset;            // within the vertex
+};
+
+struct MeshLOD
+{
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    // largest distance between this LOD's surface and LOD0's, both ways, in model units
+    // (measured by mesh_convert with meshDistance(), see mesh_simplify.h)
+    float error;
+    // the meshlets that split this LOD's index range, in index order
+    uint32_t firstMeshlet;
+    uint32_t meshletCount;
+};
+
+// a cluster of at most MESHLET_MAX_VERTICES vertices and MESHLET_MAX_TRIANGLES triangles,
+// one contiguous run of the index blob, with model space bounds for culling it as a whole
+struct Meshlet
+{
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    float center[3];            // bounding sphere
+    float radius;
+    float coneAxis[3];          // average facing of the triangles
+    float coneCutoff;           // sine of the cone's half angle; 1 never culls
+};
+
+// a run of the index blob, as drawn
+struct IndexRange
+{
+    uint32_t firstIndex;
+    uint32_t indexCount;
+};
+
+// attributes matching vertexFormatAttributes() for the labs' position + color layouts
+// ------------------------------------------------------------------------
+inline std::vector<MeshAttribute> vertexFormatLayout(VertexFormat format)
+{
+    std::vector<MeshAttribute> attributes;
+    if (format == VERTEX_FLOAT)
+    {
+        attributes.push_back({ 0, 3, GL_FLOAT, GL_FALSE, 0 });
+        attributes.push_back({ 1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float) });
+    }
+    else
+    {
+        attributes.push_back({ 0, 4, (uint32_t)(format == VERTEX_HALF ? GL_HALF_FLOAT : GL_SHORT), (uint32_t)(format == VERTEX_HALF ? GL_FALSE : GL_TRUE), 0 });
+        attributes.push_back({ 1, 4, GL_UNSIGNED_BYTE, GL_TRUE, (uint32_t)offsetof(PackedVertex, color) });
+    }
+    return attributes;
+}
+
+// a mesh as tools/mesh_convert.cpp assembles it before writeMeshFile()
+struct MeshData
+{
+    VertexFormat format = VERTEX_FLOAT;
+    PositionTransform position;
+    glm::vec3 boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsMax = glm::vec3(0.0f);
+    uint32_t vertexStride = 0;
+    uint32_t vertexCount = 0;
+    std::vector<unsigned char> vertices;
+    GLenum indexType = GL_UNSIGNED_INT;
+    uint32_t indexCount = 0;
+    std::vector<unsigned char> indices;
+    std::vector<MeshAttribute> attributes;
+    std::vector<MeshLOD> lods;
+    std::vector<Meshlet> meshlets;
+};
+
+// write mesh to path in the layout above; false (with a message) on failure
+// ------------------------------------------------------------------------
+inline bool writeMeshFile(const std::string& path, const MeshData& mesh)
+{
+    MeshFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "MESH", 4);
+    header.version = MESH_FILE_VERSION;
+    header.vertexFormat = (uint32_t)mesh.format;
+    header.vertexStride = mesh.vertexStride;
+    header.vertexCount = mesh.vertexCount;
+    header.indexType = (uint32_t)mesh.indexType;
+    header.indexCount = mesh.indexCount;
+    header.attributeCount = (uint32_t)mesh.attributes.size();
+    header.lodCount = (uint32_t)mesh.lods.size();
+    header.meshletCount = (uint32_t)mesh.meshlets.size();
+    for (int axis = 0; axis < 3; axis++)
+    {
+        header.boundsMin[axis] = mesh.boundsMin[axis];
+        header.boundsMax[axis] = mesh.boundsMax[axis];
+        header.positionScale[axis] = mesh.position.scale[axis];
+        header.positionBias[axis] = mesh.position.bias[axis];
+    }
+    uint64_t tables = sizeof(MeshFileHeader) + mesh.attributes.size() * sizeof(MeshAttribute) + mesh.lods.size() * sizeof(MeshLOD)
+        + mesh.meshlets.size() * sizeof(Meshlet);
+    header.vertexOffset = (tables + MESH_FILE_ALIGNMENT - 1) / MESH_FILE_ALIGNMENT * MESH_FILE_ALIGNMENT;
+    header.vertexBytes = mesh.vertices.size();
+    header.indexOffset = (header.vertexOffset + header.vertexBytes + MESH_FILE_ALIGNMENT - 1) / MESH_FILE_ALIGNMENT * MESH_FILE_ALIGNMENT;
+    header.indexBytes = mesh.indices.size();
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        std::cout << "ERROR::MESH_FILE::CANNOT_WRITE: " << path << std::endl;
+        return false;
+    }
+    const std::vector<char> padding(MESH_FILE_ALIGNMENT, 0);
+    out.write((const char*)&header, sizeof(header));
+    out.write((const char*)mesh.attributes.data(), mesh.attributes.size() * sizeof(MeshAttribute));
+    out.write((const char*)mesh.lods.data(), mesh.lods.size() * sizeof(MeshLOD));
+    out.write((const char*)mesh.meshlets.data(), mesh.meshlets.size() * sizeof(Meshlet));
+    out.write(padding.data(), header.vertexOffset - tables);
+    out.write((const char*)mesh.vertices.data(), mesh.vertices.size());
+    out.write(padding.data(), header.indexOffset - header.vertexOffset - header.vertexBytes);
+    out.write((const char*)mesh.indices.data(), mesh.indices.size());
+    if (!out)
+    {
+        std::cout << "ERROR::MESH_FILE::CANNOT_WRITE: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// a mapped, validated mesh file; every pointer it returns points into the mapping
+class MeshFile
+{
+public:
+    explicit MeshFile(const std::string& path) : file(path), valid(false)
+    {
+        if (!file.isValid())
+        {
+            std::cout << "ERROR::MESH_FILE::FILE_NOT_SUCCESSFULLY_READ: " << path << std::endl;
+            return;
+        }
+        const char* error = validate();
+        if (error)
+        {
+            std::cout << "ERROR::MESH_FILE::" << error << ": " << path << std::endl;
+            return;
+        }
+        valid = true;
+    }
+
+    MeshFile(const MeshFile&) = delete;
+    MeshFile& operator=(const MeshFile&) = delete;
+
+    bool isValid() const
+    {
+        return valid;
+    }
+
+    const MeshFileHeader& header() const
+    {
+        return *(const MeshFileHeader*)file.data();
+    }
+    const MeshAttribute* attributes() const
+    {
+        return (const MeshAttribute*)(file.data() + sizeof(MeshFileHeader));
+    }
+    const MeshLOD* lods() const
+    {
+        return (const MeshLOD*)(attributes() + header().attributeCount);
+    }
+    const Meshlet* meshlets() const
+    {
+        return (const Meshlet*)(lods() + header().lodCount);
+    }
+    const void* vertexData() const
+    {
+        return file.data() + header().vertexOffset;
+    }
+    const void* indexData() const
+    {
+        return file.data() + header().indexOffset;
+    }
+
+    VertexFormat format() const
+    {
+        return (VertexFormat)header().vertexFormat;
+    }
+    GLenum indexType() const
+    {
+        return (GLenum)header().indexType;
+    }
+    PositionTransform positionTransform() const
+    {
+        PositionTransform transform;
+        transform.scale = glm::vec3(header().positionScale[0], header().positionScale[1], header().positionScale[2]);
+        transform.bias = glm::vec3(header().positionBias[0], header().positionBias[1], header().positionBias[2]);
+        return transform;
+    }
+    size_t size() const
+    {
+        return file.size();
+    }
+
+    // point and enable the described attributes of the bound VAO at the bound GL_ARRAY_BUFFER
+    // ------------------------------------------------------------------------
+    void vertexAttributes() const
+    {
+        for (uint32_t i = 0; i < header().attributeCount; i++)
+        {
+            const MeshAttribute& attribute = attributes()[i];
+            glVertexAttribPointer(attribute.location, attribute.components, attribute.type, attribute.normalized ? GL_TRUE : GL_FALSE,
+                header().vertexStride, (void*)(uintptr_t)attribute.offset);
+            glEnableVertexAttribArray(attribute.location);
+        }
+    }
+
+private:
+    MappedFile file;
+    bool valid;
+
+    // name of the first problem found, or nullptr; nothing past the mapping is ever read
+    const char* validate() const
+    {
+        if (file.size() < sizeof(MeshFileHeader))
+            return "TRUNCATED";
+        const MeshFileHeader& h = header();
+        if (std::memcmp(h.magic, "MESH", 4) != 0)
+            return "NOT_A_MESH_FILE";
+        if (h.version != MESH_FILE_VERSION)
+            return "UNSUPPORTED_VERSION";
+        if (h.vertexFormat > VERTEX_SNORM16 || (h.indexType != GL_UNSIGNED_BYTE && h.indexType != GL_UNSIGNED_SHORT && h.indexType != GL_UNSIGNED_INT))
+            return "UNKNOWN_FORMAT";
+        uint64_t tables = sizeof(MeshFileHeader) + (uint64_t)h.attributeCount * sizeof(MeshAttribute) + (uint64_t)h.lodCount * sizeof(MeshLOD)
+            + (uint64_t)h.meshletCount * sizeof(Meshlet);
+        if (tables > file.size() || h.vertexOffset < tables || h.indexOffset < h.vertexOffset + h.vertexBytes
+            || h.vertexOffset > file.size() || h.vertexBytes > file.size() - h.vertexOffset
+            || h.indexOffset > file.size() || h.indexBytes > file.size() - h.indexOffset)
+            return "TRUNCATED";
+        if (h.vertexBytes != (uint64_t)h.vertexCount * h.vertexStride || h.indexBytes != (uint64_t)h.indexCount * indexSize(h.indexType))
+            return "SIZE_MISMATCH";
+        for (uint32_t i = 0; i < h.lodCount; i++)
+            if ((uint64_t)lods()[i].firstIndex + lods()[i].indexCount > h.indexCount
+                || (uint64_t)lods()[i].firstMeshlet + lods()[i].meshletCount > h.meshletCount)
+                return "LOD_OUT_OF_RANGE";
+        for (uint32_t i = 0; i < h.meshletCount; i++)
+            if ((uint64_t)meshlets()[i].firstIndex + meshlets()[i].indexCount > h.indexCount)
+                return "MESHLET_OUT_OF_RANGE";
+        return nullptr;
+    }
+};
+#endif
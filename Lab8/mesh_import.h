@@ -0,0 +1,645 @@
+//
+//  mesh_import.h
+//  3D Object Drawing
+//
+//  OBJ and PLY (ascii / binary little endian) import into the labs' interleaved
+//  pos[3] + color[3] layout, ready for packVertices() or a VERTEX_FLOAT VAO.
+//  The file is memory-mapped and cut into one chunk per hardware thread at line
+//  boundaries; every chunk is parsed on its own thread with std::from_chars and
+//  the results are stitched together in file order. Identical vertices are
+//  merged afterwards and triangles that collapse in the merge are dropped.
+//
+//      ImportedMesh mesh;
+//      if (importMesh("bunny.obj", mesh))
+//          std::cout << mesh.megabytesPerSecond() << " MB/s" << std::endl;
+//
+//  OBJ: "v x y z [r g b]" and "f" lines (polygons are fanned, v/vt/vn and
+//  negative indices are accepted); everything else is skipped. PLY: the x, y, z
+//  and red, green, blue properties of "vertex" and the index list of "face".
+//  Vertices without a color get defaultColor.
+//
+
+#ifndef MESH_IMPORT_H
+#define MESH_IMPORT_H
+
+#include <glm/glm.hpp>
+#include "mapped_file.h"
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <charconv>
+#include <iostream>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <cstdint>
+
+struct ImportedMesh
+{
+    // pos[3] + color[3] per vertex
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    // vertices merged into an identical one, triangles dropped because of it
+    size_t mergedVertices = 0;
+    size_t droppedTriangles = 0;
+    size_t fileBytes = 0;
+    double seconds = 0.0;
+    unsigned int threads = 0;
+
+    size_t vertexCount() const
+    {
+        return vertices.size() / 6;
+    }
+    double megabytesPerSecond() const
+    {
+        return seconds > 0.0 ? fileBytes / seconds / 1e6 : 0.0;
+    }
+};
+
+// the number at p, skipping blanks; from_chars does not take a leading '+', so that is skipped too
+// ------------------------------------------------------------------------
+template <typename T>
+inline bool readNumber(const char*& p, const char* end, T& value)
+{
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+        p++;
+    if (p < end && *p == '+')
+        p++;
+    std::from_chars_result result = std::from_chars(p, end, value);
+    if (result.ec != std::errc())
+        return false;
+    p = result.ptr;
+    return true;
+}
+
+// start of the line after p (or end)
+inline const char* nextLine(const char* p, const char* end)
+{
+    const char* newline = (const char*)std::memchr(p, '\n', end - p);
+    return newline ? newline + 1 : end;
+}
+
+// splits [begin, end) into about count ranges ending at line ends and runs body(i, first, last) on a thread each
+// ------------------------------------------------------------------------
+template <typename Body>
+inline unsigned int parseChunks(const char* begin, const char* end, unsigned int count, const Body& body)
+{
+    std::vector<const char*> bounds(1, begin);
+    for (unsigned int i = 1; i < count; i++)
+    {
+        const char* cut = nextLine(begin + (end - begin) * i / count, end);
+        bounds.push_back(std::max(cut, bounds.back()));
+    }
+    bounds.push_back(end);
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < count; i++)
+        threads.emplace_back([&, i]() { body(i, bounds[i], bounds[i + 1]); });
+    body(0, bounds[0], bounds[1]);
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+    return count;
+}
+
+// what one thread made of its part of an OBJ file
+struct ObjChunk
+{
+    std::vector<float> vertices;
+    // >= 0: 0-based index into the whole file; >= RELATIVE: RELATIVE + index counted from this chunk's first vertex
+    std::vector<int64_t> corners;
+    size_t badLines = 0;
+    static const int64_t RELATIVE = (int64_t)1 << 40;
+};
+
+// ------------------------------------------------------------------------
+inline void parseObjChunk(const char* p, const char* end, const glm::vec3& defaultColor, ObjChunk& chunk)
+{
+    std::vector<int64_t> polygon;
+    while (p < end)
+    {
+        const char* lineEnd = nextLine(p, end);
+        while (p < lineEnd && (*p == ' ' || *p == '\t'))
+            p++;
+        if (lineEnd - p > 2 && p[0] == 'v' && (p[1] == ' ' || p[1] == '\t'))
+        {
+            p += 2;
+            float v[6] = { 0.0f, 0.0f, 0.0f, defaultColor.r, defaultColor.g, defaultColor.b };
+            if (!readNumber(p, lineEnd, v[0]) || !readNumber(p, lineEnd, v[1]) || !readNumber(p, lineEnd, v[2]))
+                chunk.badLines++;
+            // "v x y z r g b" is the common vertex color extension
+            float color[3];
+            if (readNumber(p, lineEnd, color[0]) && readNumber(p, lineEnd, color[1]) && readNumber(p, lineEnd, color[2]))
+                std::memcpy(&v[3], color, sizeof(color));
+            chunk.vertices.insert(chunk.vertices.end(), v, v + 6);
+        }
+        else if (lineEnd - p > 2 && p[0] == 'f' && (p[1] == ' ' || p[1] == '\t'))
+        {
+            p += 2;
+            polygon.clear();
+            int64_t index;
+            while (readNumber(p, lineEnd, index))
+            {
+                if (index > 0)
+                    polygon.push_back(index - 1);
+                else if (index < 0)
+                    polygon.push_back(ObjChunk::RELATIVE + (int64_t)(chunk.vertices.size() / 6) + index);
+                // texture coordinate and normal indices are not needed
+                while (p < lineEnd && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n')
+                    p++;
+            }
+            if (polygon.size() < 3)
+                chunk.badLines++;
+            for (size_t i = 2; i < polygon.size(); i++)
+            {
+                chunk.corners.push_back(polygon[0]);
+                chunk.corners.push_back(polygon[i - 1]);
+                chunk.corners.push_back(polygon[i]);
+            }
+        }
+        p = lineEnd;
+    }
+}
+
+// ------------------------------------------------------------------------
+inline bool importObj(const char* begin, const char* end, unsigned int threadCount, const glm::vec3& defaultColor, ImportedMesh& mesh)
+{
+    std::vector<ObjChunk> chunks(threadCount);
+    mesh.threads = parseChunks(begin, end, threadCount, [&](unsigned int i, const char* first, const char* last)
+    {
+        parseObjChunk(first, last, defaultColor, chunks[i]);
+    });
+
+    size_t vertexFloats = 0, cornerCount = 0, badLines = 0;
+    for (const ObjChunk& chunk : chunks)
+    {
+        vertexFloats += chunk.vertices.size();
+        cornerCount += chunk.corners.size();
+        badLines += chunk.badLines;
+    }
+    if (badLines)
+        std::cout << "ERROR::MESH_IMPORT::OBJ_LINES_SKIPPED " << badLines << std::endl;
+    mesh.vertices.reserve(vertexFloats);
+    mesh.indices.reserve(cornerCount);
+    const int64_t vertexCount = (int64_t)(vertexFloats / 6);
+    int64_t chunkBase = 0;
+    for (const ObjChunk& chunk : chunks)
+    {
+        mesh.vertices.insert(mesh.vertices.end(), chunk.vertices.begin(), chunk.vertices.end());
+        for (int64_t corner : chunk.corners)
+        {
+            int64_t index = corner >= ObjChunk::RELATIVE / 2 ? chunkBase + corner - ObjChunk::RELATIVE : corner;
+            if (index < 0 || index >= vertexCount)
+            {
+                std::cout << "ERROR::MESH_IMPORT::INDEX_OUT_OF_RANGE " << index << std::endl;
+                return false;
+            }
+            mesh.indices.push_back((unsigned int)index);
+        }
+        chunkBase += (int64_t)(chunk.vertices.size() / 6);
+    }
+    return true;
+}
+
+// a PLY scalar type, resolved once from its name
+struct PlyType
+{
+    // bytes, 0 for an unknown name
+    size_t size = 0;
+    bool isFloat = false;
+    bool isUnsigned = false;
+};
+
+inline PlyType plyType(const std::string& name)
+{
+    PlyType type;
+    type.isFloat = name == "float" || name == "float32" || name == "double" || name == "float64";
+    type.isUnsigned = name[0] == 'u';
+    if (name == "char" || name == "uchar" || name == "int8" || name == "uint8")
+        type.size = 1;
+    else if (name == "short" || name == "ushort" || name == "int16" || name == "uint16")
+        type.size = 2;
+    else if (name == "int" || name == "uint" || name == "float" || name == "int32" || name == "uint32" || name == "float32")
+        type.size = 4;
+    else if (name == "double" || name == "float64")
+        type.size = 8;
+    return type;
+}
+
+// a little endian PLY scalar at p
+// ------------------------------------------------------------------------
+inline double readPlyValue(const char* p, PlyType type)
+{
+    if (type.isFloat)
+    {
+        if (type.size == 8)
+        {
+            double v;
+            std::memcpy(&v, p, 8);
+            return v;
+        }
+        float v;
+        std::memcpy(&v, p, 4);
+        return v;
+    }
+    if (type.size == 1)
+    {
+        uint8_t v;
+        std::memcpy(&v, p, 1);
+        return type.isUnsigned ? (double)v : (double)(int8_t)v;
+    }
+    if (type.size == 2)
+    {
+        uint16_t v;
+        std::memcpy(&v, p, 2);
+        return type.isUnsigned ? (double)v : (double)(int16_t)v;
+    }
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    return type.isUnsigned ? (double)v : (double)(int32_t)v;
+}
+
+// slot of a vertex property in pos[3] + color[3], or -1
+inline int plyVertexSlot(const std::string& name)
+{
+    static const char* names[6] = { "x", "y", "z", "red", "green", "blue" };
+    for (int slot = 0; slot < 6; slot++)
+        if (name == names[slot] || (slot >= 3 && name == std::string("diffuse_") + names[slot]))
+            return slot;
+    return -1;
+}
+
+// one "property" line of a PLY header
+struct PlyProperty
+{
+    PlyType type;
+    // "property list <countType> <type> name"
+    bool list = false;
+    PlyType countType;
+    // where a vertex property goes in pos[3] + color[3], or -1
+    int slot = -1;
+    // applied to the value stored there
+    float scale = 1.0f;
+    // the face's vertex_indices list
+    bool indices = false;
+};
+
+struct PlyElement
+{
+    std::string name;
+    size_t count = 0;
+    std::vector<PlyProperty> properties;
+};
+
+// ------------------------------------------------------------------------
+inline bool importPly(const char* begin, const char* end, unsigned int threadCount, const glm::vec3& defaultColor, ImportedMesh& mesh)
+{
+    // header
+    std::vector<PlyElement> elements;
+    std::string format;
+    const char* p = begin;
+    while (true)
+    {
+        if (p >= end)
+        {
+            std::cout << "ERROR::MESH_IMPORT::PLY_HEADER_NOT_TERMINATED" << std::endl;
+            return false;
+        }
+        const char* lineEnd = nextLine(p, end);
+        std::string line(p, lineEnd);
+        p = lineEnd;
+        while (!line.empty() && (line.back() == '\n' || line.back() == '\r'))
+            line.pop_back();
+        std::vector<std::string> words;
+        for (size_t at = 0; at < line.size();)
+        {
+            size_t next = line.find(' ', at);
+            if (next == std::string::npos)
+                next = line.size();
+            if (next > at)
+                words.push_back(line.substr(at, next - at));
+            at = next + 1;
+        }
+        if (words.empty())
+            continue;
+        if (words[0] == "end_header")
+            break;
+        if (words[0] == "format" && words.size() > 1)
+            format = words[1];
+        else if (words[0] == "element" && words.size() > 2)
+        {
+            PlyElement element;
+            element.name = words[1];
+            element.count = (size_t)std::strtoull(words[2].c_str(), nullptr, 10);
+            elements.push_back(element);
+        }
+        else if (words[0] == "property" && !elements.empty())
+        {
+            PlyProperty property;
+            std::string name;
+            if (words.size() > 4 && words[1] == "list")
+            {
+                property.list = true;
+                property.countType = plyType(words[2]);
+                property.type = plyType(words[3]);
+                name = words[4];
+            }
+            else if (words.size() > 2)
+            {
+                property.type = plyType(words[1]);
+                name = words[2];
+            }
+            if (elements.back().name == "vertex" && !property.list)
+                property.slot = plyVertexSlot(name);
+            property.indices = elements.back().name == "face" && property.list && (name == "vertex_indices" || name == "vertex_index");
+            // 8-bit integer colors are 0 - 255
+            if (property.slot >= 3 && !property.type.isFloat && property.type.size == 1)
+                property.scale = 1.0f / 255.0f;
+            if (property.type.size == 0 || (property.list && property.countType.size == 0))
+            {
+                std::cout << "ERROR::MESH_IMPORT::PLY_UNKNOWN_TYPE " << line << std::endl;
+                return false;
+            }
+            elements.back().properties.push_back(property);
+        }
+    }
+    bool ascii = format == "ascii";
+    if (!ascii && format != "binary_little_endian")
+    {
+        std::cout << "ERROR::MESH_IMPORT::PLY_FORMAT_NOT_SUPPORTED " << format << std::endl;
+        return false;
+    }
+
+    for (const PlyElement& element : elements)
+    {
+        bool isVertex = element.name == "vertex", isFace = element.name == "face";
+        if (ascii)
+        {
+            // line starts every element.count / threadCount lines, so each thread knows where its rows land
+            std::vector<const char*> starts(1, p);
+            std::vector<size_t> firstRows(1, 0);
+            size_t rowsPerChunk = std::max((element.count + threadCount - 1) / threadCount, (size_t)1);
+            for (size_t row = 0; row < element.count; row++)
+            {
+                if (p >= end)
+                {
+                    std::cout << "ERROR::MESH_IMPORT::PLY_TRUNCATED " << element.name << std::endl;
+                    return false;
+                }
+                p = nextLine(p, end);
+                if ((row + 1) % rowsPerChunk == 0 && row + 1 < element.count)
+                {
+                    starts.push_back(p);
+                    firstRows.push_back(row + 1);
+                }
+            }
+            starts.push_back(p);
+            if (!isVertex && !isFace)
+                continue;
+
+            size_t vertexBase = mesh.vertices.size();
+            if (isVertex)
+                mesh.vertices.resize(vertexBase + element.count * 6);
+            std::vector<std::vector<unsigned int> > faceChunks(firstRows.size());
+            std::vector<std::thread> threads;
+            auto parseRows = [&](size_t chunk)
+            {
+                std::vector<unsigned int> polygon;
+                const char* q = starts[chunk];
+                for (size_t row = firstRows[chunk]; q < starts[chunk + 1]; row++)
+                {
+                    const char* lineEnd = nextLine(q, starts[chunk + 1]);
+                    float* v = isVertex ? &mesh.vertices[vertexBase + row * 6] : nullptr;
+                    if (v)
+                    {
+                        v[0] = v[1] = v[2] = 0.0f;
+                        v[3] = defaultColor.r;
+                        v[4] = defaultColor.g;
+                        v[5] = defaultColor.b;
+                    }
+                    for (const PlyProperty& property : element.properties)
+                    {
+                        double value = 0.0;
+                        if (property.list)
+                        {
+                            size_t count = 0;
+                            readNumber(q, lineEnd, count);
+                            polygon.clear();
+                            for (size_t i = 0; i < count && readNumber(q, lineEnd, value); i++)
+                                polygon.push_back((unsigned int)value);
+                            if (property.indices)
+                                for (size_t i = 2; i < polygon.size(); i++)
+                                {
+                                    faceChunks[chunk].push_back(polygon[0]);
+                                    faceChunks[chunk].push_back(polygon[i - 1]);
+                                    faceChunks[chunk].push_back(polygon[i]);
+                                }
+                            continue;
+                        }
+                        readNumber(q, lineEnd, value);
+                        if (v && property.slot >= 0)
+                            v[property.slot] = (float)value * property.scale;
+                    }
+                    q = lineEnd;
+                }
+            };
+            for (size_t chunk = 1; chunk < firstRows.size(); chunk++)
+                threads.emplace_back(parseRows, chunk);
+            parseRows(0);
+            for (size_t i = 0; i < threads.size(); i++)
+                threads[i].join();
+            mesh.threads = std::max(mesh.threads, (unsigned int)firstRows.size());
+            for (const std::vector<unsigned int>& faces : faceChunks)
+                mesh.indices.insert(mesh.indices.end(), faces.begin(), faces.end());
+            continue;
+        }
+
+        // binary: fixed-size rows are converted in parallel, rows with lists are walked in order
+        size_t rowSize = 0;
+        bool fixed = true;
+        for (const PlyProperty& property : element.properties)
+        {
+            fixed = fixed && !property.list;
+            rowSize += property.type.size;
+        }
+        if (fixed)
+        {
+            if ((size_t)(end - p) < element.count * rowSize)
+            {
+                std::cout << "ERROR::MESH_IMPORT::PLY_TRUNCATED " << element.name << std::endl;
+                return false;
+            }
+            if (isVertex)
+            {
+                size_t vertexBase = mesh.vertices.size();
+                mesh.vertices.resize(vertexBase + element.count * 6);
+                const char* rows = p;
+                unsigned int chunks = (unsigned int)std::min<size_t>(threadCount, std::max<size_t>(element.count / 4096, 1));
+                std::vector<std::thread> threads;
+                auto convertRows = [&](size_t first, size_t last)
+                {
+                    for (size_t row = first; row < last; row++)
+                    {
+                        float* v = &mesh.vertices[vertexBase + row * 6];
+                        v[0] = v[1] = v[2] = 0.0f;
+                        v[3] = defaultColor.r;
+                        v[4] = defaultColor.g;
+                        v[5] = defaultColor.b;
+                        const char* q = rows + row * rowSize;
+                        for (const PlyProperty& property : element.properties)
+                        {
+                            if (property.slot >= 0)
+                                v[property.slot] = (float)readPlyValue(q, property.type) * property.scale;
+                            q += property.type.size;
+                        }
+                    }
+                };
+                for (unsigned int i = 1; i < chunks; i++)
+                    threads.emplace_back(convertRows, element.count * i / chunks, element.count * (i + 1) / chunks);
+                convertRows(0, element.count / chunks);
+                for (size_t i = 0; i < threads.size(); i++)
+                    threads[i].join();
+                mesh.threads = std::max(mesh.threads, chunks);
+            }
+            p += element.count * rowSize;
+            continue;
+        }
+        std::vector<unsigned int> polygon;
+        for (size_t row = 0; row < element.count; row++)
+            for (const PlyProperty& property : element.properties)
+            {
+                size_t countSize = property.list ? property.countType.size : 0;
+                size_t itemSize = property.type.size;
+                if ((size_t)(end - p) < countSize + itemSize)
+                {
+                    std::cout << "ERROR::MESH_IMPORT::PLY_TRUNCATED " << element.name << std::endl;
+                    return false;
+                }
+                if (!property.list)
+                {
+                    p += itemSize;
+                    continue;
+                }
+                size_t count = (size_t)readPlyValue(p, property.countType);
+                p += countSize;
+                if ((size_t)(end - p) < count * itemSize)
+                {
+                    std::cout << "ERROR::MESH_IMPORT::PLY_TRUNCATED " << element.name << std::endl;
+                    return false;
+                }
+                if (property.indices)
+                {
+                    polygon.clear();
+                    for (size_t i = 0; i < count; i++)
+                        polygon.push_back((unsigned int)readPlyValue(p + i * itemSize, property.type));
+                    for (size_t i = 2; i < polygon.size(); i++)
+                    {
+                        mesh.indices.push_back(polygon[0]);
+                        mesh.indices.push_back(polygon[i - 1]);
+                        mesh.indices.push_back(polygon[i]);
+                    }
+                }
+                p += count * itemSize;
+            }
+    }
+
+    size_t vertexCount = mesh.vertexCount();
+    for (unsigned int index : mesh.indices)
+        if (index >= vertexCount)
+        {
+            std::cout << "ERROR::MESH_IMPORT::INDEX_OUT_OF_RANGE " << index << std::endl;
+            return false;
+        }
+    return true;
+}
+
+// merge vertices with identical bits and drop the triangles that collapse
+// ------------------------------------------------------------------------
+inline void mergeDuplicateVertices(ImportedMesh& mesh)
+{
+    const size_t vertexCount = mesh.vertexCount();
+    size_t capacity = 16;
+    while (capacity < vertexCount * 2)
+        capacity *= 2;
+    // open addressing over vertex numbers; EMPTY marks a free slot
+    const unsigned int EMPTY = 0xFFFFFFFFu;
+    std::vector<unsigned int> table(capacity, EMPTY);
+    std::vector<unsigned int> remap(vertexCount);
+    size_t unique = 0;
+    for (size_t v = 0; v < vertexCount; v++)
+    {
+        const float* vertex = &mesh.vertices[v * 6];
+        uint32_t words[6];
+        std::memcpy(words, vertex, sizeof(words));
+        uint64_t hash = 14695981039346656037ull;
+        for (int i = 0; i < 6; i++)
+        {
+            hash ^= words[i];
+            hash *= 1099511628211ull;
+        }
+        size_t slot = (size_t)(hash ^ (hash >> 32)) & (capacity - 1);
+        while (table[slot] != EMPTY && std::memcmp(&mesh.vertices[table[slot] * 6], vertex, 6 * sizeof(float)) != 0)
+            slot = (slot + 1) & (capacity - 1);
+        if (table[slot] == EMPTY)
+        {
+            // compacting in place: the unique vertex lands at or before where it was read
+            table[slot] = (unsigned int)unique;
+            std::memmove(&mesh.vertices[unique * 6], vertex, 6 * sizeof(float));
+            unique++;
+        }
+        remap[v] = table[slot];
+    }
+    mesh.mergedVertices = vertexCount - unique;
+    mesh.vertices.resize(unique * 6);
+
+    size_t kept = 0;
+    for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+    {
+        unsigned int a = remap[mesh.indices[i]], b = remap[mesh.indices[i + 1]], c = remap[mesh.indices[i + 2]];
+        if (a == b || b == c || a == c)
+            continue;
+        mesh.indices[kept++] = a;
+        mesh.indices[kept++] = b;
+        mesh.indices[kept++] = c;
+    }
+    mesh.droppedTriangles = (mesh.indices.size() - kept) / 3;
+    mesh.indices.resize(kept);
+}
+
+// load an .obj or .ply file into mesh; false (with a message) on failure
+// ------------------------------------------------------------------------
+inline bool importMesh(const std::string& path, ImportedMesh& mesh, const glm::vec3& defaultColor = glm::vec3(0.8f))
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    mesh = ImportedMesh();
+    MappedFile file(path);
+    if (!file.isValid())
+    {
+        std::cout << "ERROR::MESH_IMPORT::FILE_NOT_SUCCESSFULLY_READ: " << path << std::endl;
+        return false;
+    }
+    mesh.fileBytes = file.size();
+    const char* begin = file.data();
+    const char* end = begin + file.size();
+
+    // below a megabyte the threads cost more than they save
+    unsigned int threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    threadCount = (unsigned int)std::min<size_t>(threadCount, file.size() / (1 << 20) + 1);
+
+    std::string extension = path.substr(path.find_last_of('.') + 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return (char)tolower((unsigned char)c); });
+    bool imported = false;
+    if (extension == "obj")
+        imported = importObj(begin, end, threadCount, defaultColor, mesh);
+    else if (extension == "ply")
+        imported = importPly(begin, end, threadCount, defaultColor, mesh);
+    else
+        std::cout << "ERROR::MESH_IMPORT::UNKNOWN_EXTENSION: " << path << std::endl;
+    if (!imported)
+        return false;
+
+    mergeDuplicateVertices(mesh);
+    mesh.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+#endif
@@ -0,0 +1,88 @@
+//
+//  mesh_lod.h
+//  3D Object Drawing
+//
+//  Screen-space LOD selection for a mesh file's LOD chain (mesh_convert --lods).
+//  Each instance's bounding sphere is projected with the camera's perspective
+//  (Camera::Zoom is the vertical field of view), which gives how many pixels one
+//  model unit covers at its distance; the coarsest LOD whose distance from LOD0
+//  (MeshLOD::error) stays under maxPixelError at that size is drawn.
+//
+//      LODSelector cubeLODs(cubeMesh);
+//      cubeLODs.setView(camera, SCR_HEIGHT);           // once per frame
+//      batch.add(model, color, cubeLODs.select(model));
+//
+
+#ifndef MESH_LOD_H
+#define MESH_LOD_H
+
+#include <glm/glm.hpp>
+
+#include "camera.h"
+#include "mesh_file.h"
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+class LODSelector
+{
+public:
+    // largest error, in pixels, a coarser LOD may show
+    float maxPixelError;
+
+    explicit LODSelector(const MeshFile& mesh, float pixelError = 1.0f)
+        : maxPixelError(pixelError), lods(mesh.lods(), mesh.lods() + mesh.header().lodCount), eye(0.0f), pixelsPerUnit(1.0f)
+    {
+        glm::vec3 boundsMin(mesh.header().boundsMin[0], mesh.header().boundsMin[1], mesh.header().boundsMin[2]);
+        glm::vec3 boundsMax(mesh.header().boundsMax[0], mesh.header().boundsMax[1], mesh.header().boundsMax[2]);
+        center = (boundsMin + boundsMax) * 0.5f;
+        radius = glm::length(boundsMax - boundsMin) * 0.5f;
+    }
+
+    // pixels covered by one unit at distance one, from the projection FrameUniforms builds
+    // ------------------------------------------------------------------------
+    void setView(const Camera& camera, float viewportHeight)
+    {
+        eye = camera.Position;
+        pixelsPerUnit = viewportHeight * 0.5f / std::tan(glm::radians(camera.Zoom) * 0.5f);
+    }
+
+    // index into lods() of the coarsest LOD that is good enough for an instance drawn with model
+    // ------------------------------------------------------------------------
+    unsigned int select(const glm::mat4& model) const
+    {
+        glm::vec3 worldCenter = glm::vec3(model * glm::vec4(center, 1.0f));
+        // the sphere grows with the largest axis scale of the model matrix
+        float scale = std::max(glm::length(glm::vec3(model[0])), std::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+        float worldRadius = radius * scale;
+        float distance = glm::length(worldCenter - eye);
+        if (distance <= worldRadius || radius <= 0.0f)
+            return 0;
+
+        // projected sphere radius over model radius: pixels per model unit at this instance
+        float projectedRadius = worldRadius * pixelsPerUnit / distance;
+        float pixelsPerModelUnit = projectedRadius / radius;
+        for (size_t lod = lods.size(); lod-- > 1;)
+            if (lods[lod].error * pixelsPerModelUnit <= maxPixelError)
+                return (unsigned int)lod;
+        return 0;
+    }
+
+    const MeshLOD* getLODs() const
+    {
+        return lods.data();
+    }
+    size_t getLODCount() const
+    {
+        return lods.size();
+    }
+
+private:
+    std::vector<MeshLOD> lods;
+    glm::vec3 center;
+    float radius;
+    glm::vec3 eye;
+    float pixelsPerUnit;
+};
+#endif
@@ -0,0 +1,457 @@
+//
+//  mesh_simplify.h
+//  3D Object Drawing
+//
+//  Quadric error metric simplification (Garland and Heckbert 1997) for LOD
+//  chains. Edges are collapsed onto one of their existing end points, so a
+//  simplified mesh is only a new index list over the same vertices: every LOD
+//  of a mesh shares one vertex buffer and LOD switches never touch it.
+//
+//  Vertices at the same position (per-face colors, seams) are simplified as one
+//  point; a collapsed vertex moves to the vertex at the target position it shared
+//  a triangle with, so faces keep their own attributes where they can. Open
+//  edges are held in place by extra constraint planes, and collapses that would
+//  flip a triangle are rejected.
+//  meshDistance() measures how far a result really is from the mesh it came
+//  from, for the LOD table.
+//
+//      std::vector<unsigned int> lod(indexCount);
+//      float error;
+//      lod.resize(simplifyMesh(lod.data(), indices, indexCount, vertices, vertexCount, 6 * sizeof(float),
+//          indexCount / 2, FLT_MAX, error));
+//
+
+#ifndef MESH_SIMPLIFY_H
+#define MESH_SIMPLIFY_H
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <unordered_map>
+#include <thread>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <cfloat>
+#include <cmath>
+
+// sum of weighted squared distances to a set of planes, as a symmetric 4x4 matrix
+struct Quadric
+{
+    double a2 = 0, ab = 0, ac = 0, ad = 0, b2 = 0, bc = 0, bd = 0, c2 = 0, cd = 0, d2 = 0;
+    // total weight, so evaluate() / weight is a mean squared distance
+    double weight = 0;
+
+    // plane a x + b y + c z + d = 0 with unit normal
+    void addPlane(const glm::dvec3& n, double d, double w)
+    {
+        a2 += w * n.x * n.x; ab += w * n.x * n.y; ac += w * n.x * n.z; ad += w * n.x * d;
+        b2 += w * n.y * n.y; bc += w * n.y * n.z; bd += w * n.y * d;
+        c2 += w * n.z * n.z; cd += w * n.z * d;
+        d2 += w * d * d;
+        weight += w;
+    }
+    void add(const Quadric& q)
+    {
+        a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad; b2 += q.b2; bc += q.bc; bd += q.bd;
+        c2 += q.c2; cd += q.cd; d2 += q.d2; weight += q.weight;
+    }
+    double evaluate(const glm::dvec3& p) const
+    {
+        double value = a2 * p.x * p.x + b2 * p.y * p.y + c2 * p.z * p.z + d2
+            + 2.0 * (ab * p.x * p.y + ac * p.x * p.z + bc * p.y * p.z + ad * p.x + bd * p.y + cd * p.z);
+        return std::max(value, 0.0);
+    }
+};
+
+// write at most targetIndexCount indices of a simplified indices to destination (may alias indices),
+// stopping early once the next collapse costs more than targetError; returns the index count and
+// sets resultError to the largest cost accepted. The cost is the root mean squared distance to the
+// planes merged into the collapse, in model units: it ranks collapses but does not bound how far
+// the surface moved, which meshDistance() measures
+// ------------------------------------------------------------------------
+inline size_t simplifyMesh(unsigned int* destination, const unsigned int* indices, size_t indexCount,
+    const float* vertices, size_t vertexCount, size_t vertexStride, size_t targetIndexCount, float targetError, float& resultError)
+{
+    resultError = 0.0f;
+    std::vector<unsigned int> triangles(indices, indices + indexCount - indexCount % 3);
+    auto positionOf = [&](unsigned int v)
+    {
+        const float* p = (const float*)((const unsigned char*)vertices + v * vertexStride);
+        return glm::dvec3(p[0], p[1], p[2]);
+    };
+
+    // the first vertex at each position stands for all of them
+    struct PositionHash
+    {
+        size_t operator()(const glm::vec3& p) const
+        {
+            uint32_t bits[3];
+            std::memcpy(bits, &p, sizeof(bits));
+            return (size_t)(bits[0] * 73856093u ^ bits[1] * 19349663u ^ bits[2] * 83492791u);
+        }
+    };
+    std::unordered_map<glm::vec3, unsigned int, PositionHash> firstAt;
+    std::vector<unsigned int> point(vertexCount);
+    for (unsigned int v = 0; v < vertexCount; v++)
+    {
+        const float* p = (const float*)((const unsigned char*)vertices + v * vertexStride);
+        point[v] = firstAt.emplace(glm::vec3(p[0], p[1], p[2]), v).first->second;
+    }
+
+    // quadrics of the triangle planes, area weighted, and of planes standing on open edges
+    std::vector<Quadric> quadrics(vertexCount);
+    std::unordered_map<uint64_t, int> edgeUse;
+    for (size_t t = 0; t < triangles.size(); t += 3)
+    {
+        unsigned int p[3] = { point[triangles[t]], point[triangles[t + 1]], point[triangles[t + 2]] };
+        glm::dvec3 normal = glm::cross(positionOf(p[1]) - positionOf(p[0]), positionOf(p[2]) - positionOf(p[0]));
+        double area = glm::length(normal);
+        for (int corner = 0; corner < 3; corner++)
+        {
+            unsigned int a = p[corner], b = p[(corner + 1) % 3];
+            edgeUse[(uint64_t)std::min(a, b) << 32 | std::max(a, b)]++;
+        }
+        if (area <= 0.0)
+            continue;
+        normal /= area;
+        for (int corner = 0; corner < 3; corner++)
+            quadrics[p[corner]].addPlane(normal, -glm::dot(normal, positionOf(p[0])), area * 0.5);
+    }
+    for (size_t t = 0; t < triangles.size(); t += 3)
+    {
+        unsigned int p[3] = { point[triangles[t]], point[triangles[t + 1]], point[triangles[t + 2]] };
+        glm::dvec3 normal = glm::cross(positionOf(p[1]) - positionOf(p[0]), positionOf(p[2]) - positionOf(p[0]));
+        if (glm::length(normal) <= 0.0)
+            continue;
+        for (int corner = 0; corner < 3; corner++)
+        {
+            unsigned int a = p[corner], b = p[(corner + 1) % 3];
+            if (edgeUse[(uint64_t)std::min(a, b) << 32 | std::max(a, b)] != 1)
+                continue;
+            glm::dvec3 edge = positionOf(b) - positionOf(a);
+            glm::dvec3 side = glm::cross(edge, normal);
+            double length = glm::length(side);
+            if (length <= 0.0)
+                continue;
+            side /= length;
+            // heavier than the surface so borders only move along themselves
+            double weight = 10.0 * glm::dot(edge, edge);
+            quadrics[a].addPlane(side, -glm::dot(side, positionOf(a)), weight);
+            quadrics[b].addPlane(side, -glm::dot(side, positionOf(a)), weight);
+        }
+    }
+
+    struct Collapse
+    {
+        unsigned int from, to;
+        double error;
+    };
+    std::vector<uint64_t> edges;
+    std::vector<Collapse> collapses;
+    std::vector<std::vector<unsigned int> > around(vertexCount);
+    std::vector<bool> locked(vertexCount);
+    std::vector<unsigned int> movedTo(vertexCount);
+    std::vector<unsigned int> vertexRemap(vertexCount);
+    const double maxError = targetError;
+
+    while (triangles.size() > targetIndexCount)
+    {
+        // triangles around each point, and every edge once
+        for (size_t p = 0; p < vertexCount; p++)
+            around[p].clear();
+        edges.clear();
+        for (size_t t = 0; t < triangles.size(); t += 3)
+            for (int corner = 0; corner < 3; corner++)
+            {
+                unsigned int a = point[triangles[t + corner]], b = point[triangles[t + (corner + 1) % 3]];
+                around[a].push_back((unsigned int)t);
+                edges.push_back((uint64_t)std::min(a, b) << 32 | std::max(a, b));
+            }
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+        // cheaper direction of each edge: (Qa + Qb) at the point that stays, as a mean over the planes
+        collapses.clear();
+        for (uint64_t edge : edges)
+        {
+            unsigned int a = (unsigned int)(edge >> 32), b = (unsigned int)edge;
+            Quadric q = quadrics[a];
+            q.add(quadrics[b]);
+            double weight = std::max(q.weight, 1e-30);
+            double toB = q.evaluate(positionOf(b)) / weight, toA = q.evaluate(positionOf(a)) / weight;
+            collapses.push_back(toB <= toA ? Collapse{ a, b, std::sqrt(toB) } : Collapse{ b, a, std::sqrt(toA) });
+        }
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& x, const Collapse& y) { return x.error < y.error; });
+
+        std::fill(locked.begin(), locked.end(), false);
+        for (size_t p = 0; p < vertexCount; p++)
+            movedTo[p] = (unsigned int)p;
+        size_t triangleCount = triangles.size() / 3;
+        size_t applied = 0;
+        for (const Collapse& collapse : collapses)
+        {
+            if (triangleCount * 3 <= targetIndexCount || collapse.error > maxError)
+                break;
+            if (locked[collapse.from] || locked[collapse.to] || movedTo[collapse.from] != collapse.from)
+                continue;
+
+            // reject if a remaining triangle around from would turn over or collapse to a line
+            glm::dvec3 target = positionOf(collapse.to);
+            bool flips = false;
+            size_t removed = 0;
+            for (unsigned int t : around[collapse.from])
+            {
+                unsigned int p[3] = { point[triangles[t]], point[triangles[t + 1]], point[triangles[t + 2]] };
+                if (p[0] == collapse.to || p[1] == collapse.to || p[2] == collapse.to)
+                {
+                    removed++;
+                    continue;
+                }
+                glm::dvec3 corners[3] = { positionOf(p[0]), positionOf(p[1]), positionOf(p[2]) };
+                glm::dvec3 before = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+                for (int corner = 0; corner < 3; corner++)
+                    if (p[corner] == collapse.from)
+                        corners[corner] = target;
+                glm::dvec3 after = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+                if (glm::dot(before, after) <= 1e-3 * glm::length(before) * glm::length(after) || glm::length(after) <= 0.0)
+                    flips = true;
+            }
+            if (flips)
+                continue;
+
+            // the one-ring of from is stale after this collapse, so it waits for the next pass
+            for (unsigned int t : around[collapse.from])
+                for (int corner = 0; corner < 3; corner++)
+                    locked[point[triangles[t + corner]]] = true;
+            movedTo[collapse.from] = collapse.to;
+            quadrics[collapse.to].add(quadrics[collapse.from]);
+            resultError = std::max(resultError, (float)collapse.error);
+            triangleCount -= removed;
+            applied++;
+        }
+        if (applied == 0)
+            break;
+
+        // every vertex at a collapsed point moves to a vertex at the target point, preferring one it
+        // shared a triangle with so the face keeps its attributes
+        for (size_t v = 0; v < vertexCount; v++)
+            vertexRemap[v] = movedTo[point[v]] == point[v] ? (unsigned int)v : movedTo[point[v]];
+        for (size_t t = 0; t < triangles.size(); t += 3)
+            for (int corner = 0; corner < 3; corner++)
+            {
+                unsigned int v = triangles[t + corner];
+                unsigned int target = movedTo[point[v]];
+                if (target == point[v])
+                    continue;
+                for (int other = 0; other < 3; other++)
+                    if (point[triangles[t + other]] == target)
+                        vertexRemap[v] = triangles[t + other];
+            }
+        for (size_t p = 0; p < vertexCount; p++)
+            if (movedTo[p] != p)
+                point[p] = movedTo[p];
+
+        size_t kept = 0;
+        for (size_t t = 0; t < triangles.size(); t += 3)
+        {
+            unsigned int a = vertexRemap[triangles[t]], b = vertexRemap[triangles[t + 1]], c = vertexRemap[triangles[t + 2]];
+            if (point[a] == point[b] || point[b] == point[c] || point[a] == point[c])
+                continue;
+            triangles[kept++] = a;
+            triangles[kept++] = b;
+            triangles[kept++] = c;
+        }
+        triangles.resize(kept);
+    }
+
+    std::memcpy(destination, triangles.data(), triangles.size() * sizeof(unsigned int));
+    return triangles.size();
+}
+
+// closest point to p on the triangle abc (Ericson, Real-Time Collision Detection, 5.1.5)
+// ------------------------------------------------------------------------
+inline glm::vec3 closestPointOnTriangle(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+{
+    glm::vec3 ab = b - a, ac = c - a, ap = p - a;
+    float d1 = glm::dot(ab, ap), d2 = glm::dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f)
+        return a;
+    glm::vec3 bp = p - b;
+    float d3 = glm::dot(ab, bp), d4 = glm::dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3)
+        return b;
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+        return a + ab * (d1 / (d1 - d3));
+    glm::vec3 cp = p - c;
+    float d5 = glm::dot(ab, cp), d6 = glm::dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6)
+        return c;
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+        return a + ac * (d2 / (d2 - d6));
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f)
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    // a degenerate triangle falls through the edge cases with nothing left; a corner overestimates
+    float sum = va + vb + vc;
+    if (sum <= 0.0f)
+        return a;
+    return a + ab * (vb / sum) + ac * (vc / sum);
+}
+
+// largest distance from the surface of the triangles from[0, fromCount) to the surface of
+// to[0, toCount), both indexing the same vertices; the from side is sampled at its corners
+// and on a 3 x 3 barycentric grid per triangle, on one thread per core; the to side is exact
+// ------------------------------------------------------------------------
+inline float surfaceDistance(const unsigned int* from, size_t fromCount, const unsigned int* to, size_t toCount,
+    const float* vertices, size_t vertexStride)
+{
+    auto positionOf = [&](unsigned int v)
+    {
+        const float* p = (const float*)((const unsigned char*)vertices + v * vertexStride);
+        return glm::vec3(p[0], p[1], p[2]);
+    };
+    size_t triangleCount = toCount / 3;
+    if (fromCount < 3 || triangleCount == 0)
+        return 0.0f;
+
+    // a uniform grid over the to triangles with cells about an edge long, at most 16 per triangle
+    glm::vec3 low = positionOf(to[0]), high = low;
+    float edgeSum = 0.0f;
+    for (size_t i = 0; i < triangleCount * 3; i++)
+    {
+        low = glm::min(low, positionOf(to[i]));
+        high = glm::max(high, positionOf(to[i]));
+        edgeSum += glm::length(positionOf(to[i - i % 3 + (i + 1) % 3]) - positionOf(to[i]));
+    }
+    float diagonal = glm::length(high - low);
+    float cellSize = std::max(edgeSum / (triangleCount * 3), diagonal * 1e-4f);
+    if (cellSize <= 0.0f)
+        cellSize = 1.0f;
+    glm::ivec3 dims;
+    for (;;)
+    {
+        dims = glm::ivec3(glm::floor((high - low) / cellSize)) + 1;
+        if ((double)dims.x * dims.y * dims.z <= 16.0 * triangleCount + 64.0)
+            break;
+        cellSize *= 1.25f;
+    }
+    auto cellOf = [&](const glm::vec3& p)
+    {
+        return glm::ivec3(glm::clamp(glm::floor((p - low) / cellSize), glm::vec3(-16777216.0f), glm::vec3(16777216.0f)));
+    };
+    auto cellIndex = [&](const glm::ivec3& cell)
+    {
+        return ((size_t)cell.z * dims.y + cell.y) * dims.x + cell.x;
+    };
+
+    // triangles per cell, every cell their bounding box touches, as one counting-sorted list
+    std::vector<unsigned int> cellStart((size_t)dims.x * dims.y * dims.z + 1, 0), cellTriangles;
+    for (int pass = 0; pass < 2; pass++)
+    {
+        for (size_t t = 0; t < triangleCount; t++)
+        {
+            glm::vec3 a = positionOf(to[t * 3]), b = positionOf(to[t * 3 + 1]), c = positionOf(to[t * 3 + 2]);
+            glm::ivec3 first = glm::min(cellOf(glm::min(a, glm::min(b, c))), dims - 1);
+            glm::ivec3 last = glm::min(cellOf(glm::max(a, glm::max(b, c))), dims - 1);
+            for (int z = first.z; z <= last.z; z++)
+                for (int y = first.y; y <= last.y; y++)
+                    for (int x = first.x; x <= last.x; x++)
+                    {
+                        size_t cell = cellIndex(glm::ivec3(x, y, z));
+                        if (pass == 0)
+                            cellStart[cell + 1]++;
+                        else
+                            cellTriangles[cellStart[cell]++] = (unsigned int)t;
+                    }
+        }
+        if (pass == 0)
+        {
+            for (size_t cell = 1; cell < cellStart.size(); cell++)
+                cellStart[cell] += cellStart[cell - 1];
+            cellTriangles.resize(cellStart.back());
+        }
+    }
+    // the fill moved every start to the next cell's
+    std::copy_backward(cellStart.begin(), cellStart.end() - 1, cellStart.end());
+    cellStart[0] = 0;
+
+    // search shells of cells around each sample until nothing further out can be closer
+    size_t fromTriangles = fromCount / 3;
+    unsigned int threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    threadCount = (unsigned int)std::min<size_t>(threadCount, fromTriangles / 4096 + 1);
+    std::vector<float> distances(threadCount, 0.0f);
+    auto sampleTriangles = [&](unsigned int thread)
+    {
+        std::vector<uint32_t> testedFor(triangleCount, 0);
+        uint32_t query = 0;
+        auto distanceTo = [&](const glm::vec3& p)
+        {
+            query++;
+            glm::ivec3 center = cellOf(p);
+            // how far p is from the walls of its own cell, and from the grid
+            glm::vec3 inCell = p - low - glm::vec3(center) * cellSize;
+            glm::vec3 walls = glm::min(inCell, glm::vec3(cellSize) - inCell);
+            float margin = std::max(0.0f, std::min(walls.x, std::min(walls.y, walls.z)));
+            float outside = glm::length(glm::max(glm::max(low - p, p - high), glm::vec3(0.0f)));
+            int maxRing = (int)std::ceil((outside + diagonal) / cellSize) + 1;
+            // squared until the end
+            float best = FLT_MAX;
+            for (int ring = 0; ring <= maxRing; ring++)
+            {
+                float reach = (ring - 1) * cellSize + margin;
+                if (reach > 0.0f && best <= reach * reach)
+                    break;
+                for (int z = center.z - ring; z <= center.z + ring; z++)
+                    for (int y = center.y - ring; y <= center.y + ring; y++)
+                        for (int x = center.x - ring; x <= center.x + ring; x++)
+                        {
+                            // only the shell: inner cells were searched by the rings before
+                            if (std::abs(z - center.z) != ring && std::abs(y - center.y) != ring && x != center.x - ring)
+                                x = center.x + ring;
+                            if (x < 0 || y < 0 || z < 0 || x >= dims.x || y >= dims.y || z >= dims.z)
+                                continue;
+                            size_t cell = cellIndex(glm::ivec3(x, y, z));
+                            for (unsigned int i = cellStart[cell]; i < cellStart[cell + 1]; i++)
+                            {
+                                unsigned int t = cellTriangles[i];
+                                if (testedFor[t] == query)
+                                    continue;
+                                testedFor[t] = query;
+                                glm::vec3 offset = p - closestPointOnTriangle(p, positionOf(to[t * 3]), positionOf(to[t * 3 + 1]), positionOf(to[t * 3 + 2]));
+                                best = std::min(best, glm::dot(offset, offset));
+                            }
+                        }
+            }
+            return std::sqrt(best);
+        };
+
+        for (size_t t = fromTriangles * thread / threadCount; t < fromTriangles * (thread + 1) / threadCount; t++)
+        {
+            glm::vec3 a = positionOf(from[t * 3]), b = positionOf(from[t * 3 + 1]), c = positionOf(from[t * 3 + 2]);
+            for (int i = 0; i <= 3; i++)
+                for (int j = 0; i + j <= 3; j++)
+                    distances[thread] = std::max(distances[thread], distanceTo((a * (float)i + b * (float)j + c * (float)(3 - i - j)) / 3.0f));
+        }
+    };
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < threadCount; i++)
+        threads.emplace_back(sampleTriangles, i);
+    sampleTriangles(0);
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+    return *std::max_element(distances.begin(), distances.end());
+}
+
+// how far apart the surfaces of two index lists over the same vertices are, both ways (the
+// Hausdorff distance, sampled); used to record a simplified LOD's real error against LOD0
+// ------------------------------------------------------------------------
+inline float meshDistance(const unsigned int* indicesA, size_t countA, const unsigned int* indicesB, size_t countB,
+    const float* vertices, size_t vertexStride)
+{
+    return std::max(surfaceDistance(indicesA, countA, indicesB, countB, vertices, vertexStride),
+        surfaceDistance(indicesB, countB, indicesA, countA, vertices, vertexStride));
+}
+#endif
@@ -0,0 +1,203 @@
+//
+//  meshlet_builder.h
+//  3D Object Drawing
+//
+//  Splits an index list into meshlets: small clusters of triangles that are
+//  culled together (meshlet_culling.h) and drawn as one run of the index
+//  buffer. A cluster grows from a seed triangle by adding the neighbor that
+//  brings the fewest new vertices, until it reaches MESHLET_MAX_VERTICES
+//  vertices or MESHLET_MAX_TRIANGLES triangles, so clusters stay compact and
+//  their bounding spheres and normal cones stay tight.
+//  The triangles are reordered in place so that each meshlet is contiguous;
+//  within a meshlet they keep the order they were grown in.
+//
+//      std::vector<Meshlet> meshlets;
+//      buildMeshlets(meshlets, indices.data(), indices.size(), vertices.data(), vertexCount, 6 * sizeof(float));
+//
+
+#ifndef MESHLET_BUILDER_H
+#define MESHLET_BUILDER_H
+
+#include <glm/glm.hpp>
+
+#include "mesh_file.h"
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+const size_t MESHLET_MAX_VERTICES = 64;
+const size_t MESHLET_MAX_TRIANGLES = 124;
+
+// sphere and normal cone of the triangles indices[0, indexCount)
+// ------------------------------------------------------------------------
+inline void meshletBounds(Meshlet& meshlet, const unsigned int* indices, size_t indexCount, const float* vertices, size_t vertexStride)
+{
+    auto positionOf = [&](unsigned int v)
+    {
+        const float* p = (const float*)((const unsigned char*)vertices + v * vertexStride);
+        return glm::vec3(p[0], p[1], p[2]);
+    };
+
+    glm::vec3 low = positionOf(indices[0]), high = low;
+    for (size_t i = 1; i < indexCount; i++)
+    {
+        low = glm::min(low, positionOf(indices[i]));
+        high = glm::max(high, positionOf(indices[i]));
+    }
+    glm::vec3 center = (low + high) * 0.5f;
+    float radius = 0.0f;
+    for (size_t i = 0; i < indexCount; i++)
+        radius = std::max(radius, glm::length(positionOf(indices[i]) - center));
+
+    // the axis averages the unit normals; the cone has to hold the one furthest from it
+    std::vector<glm::vec3> normals;
+    glm::vec3 axis(0.0f);
+    for (size_t i = 0; i + 2 < indexCount; i += 3)
+    {
+        glm::vec3 p0 = positionOf(indices[i]), p1 = positionOf(indices[i + 1]), p2 = positionOf(indices[i + 2]);
+        glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+        float length = glm::length(normal);
+        if (length <= 0.0f)
+            continue;
+        normals.push_back(normal / length);
+        axis += normals.back();
+    }
+    float cutoff = 1.0f;
+    if (glm::length(axis) > 0.0f)
+    {
+        axis = glm::normalize(axis);
+        float minDot = 1.0f;
+        for (const glm::vec3& normal : normals)
+            minDot = std::min(minDot, glm::dot(axis, normal));
+        // wider than about 84 degrees the cone never culls anything worth the test
+        if (minDot > 0.1f)
+            cutoff = std::sqrt(1.0f - minDot * minDot);
+    }
+
+    for (int axisIndex = 0; axisIndex < 3; axisIndex++)
+    {
+        meshlet.center[axisIndex] = center[axisIndex];
+        meshlet.coneAxis[axisIndex] = axis[axisIndex];
+    }
+    meshlet.radius = radius;
+    meshlet.coneCutoff = cutoff;
+}
+
+// reorder the triangles of indices into meshlets and append those to meshlets, with firstIndex
+// relative to indices; returns how many were appended
+// ------------------------------------------------------------------------
+inline size_t buildMeshlets(std::vector<Meshlet>& meshlets, unsigned int* indices, size_t indexCount,
+    const float* vertices, size_t vertexCount, size_t vertexStride,
+    size_t maxVertices = MESHLET_MAX_VERTICES, size_t maxTriangles = MESHLET_MAX_TRIANGLES)
+{
+    size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0)
+        return 0;
+
+    // triangles around each vertex
+    std::vector<unsigned int> adjacencyStart(vertexCount + 1, 0);
+    for (size_t i = 0; i < triangleCount * 3; i++)
+        adjacencyStart[indices[i] + 1]++;
+    for (size_t v = 0; v < vertexCount; v++)
+        adjacencyStart[v + 1] += adjacencyStart[v];
+    std::vector<unsigned int> adjacency(triangleCount * 3), fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+    for (size_t i = 0; i < triangleCount * 3; i++)
+        adjacency[fill[indices[i]]++] = (unsigned int)(i / 3);
+
+    std::vector<bool> emitted(triangleCount, false);
+    // meshlet number + 1 of the meshlet a vertex was last added to, or a triangle last queued for
+    std::vector<size_t> inMeshlet(vertexCount, 0), queuedFor(triangleCount, 0);
+    std::vector<unsigned int> order, candidates;
+    order.reserve(triangleCount);
+    size_t first = meshlets.size(), seed = 0, meshletVertices = 0, meshletTriangles = 0, meshletStart = 0;
+
+    auto newVertices = [&](unsigned int triangle)
+    {
+        size_t count = 0;
+        for (int corner = 0; corner < 3; corner++)
+            count += inMeshlet[indices[triangle * 3 + corner]] != meshlets.size() + 1;
+        return count;
+    };
+    auto closeMeshlet = [&]()
+    {
+        Meshlet meshlet;
+        meshlet.firstIndex = (uint32_t)(meshletStart * 3);
+        meshlet.indexCount = (uint32_t)(meshletTriangles * 3);
+        meshlets.push_back(meshlet);
+        meshletStart += meshletTriangles;
+        meshletVertices = meshletTriangles = 0;
+        // the next meshlet starts on this one's border
+        size_t border = 0;
+        while (border < candidates.size() && emitted[candidates[border]])
+            border++;
+        if (border < candidates.size())
+        {
+            candidates[0] = candidates[border];
+            queuedFor[candidates[0]] = meshlets.size() + 1;
+        }
+        candidates.resize(border < candidates.size() ? 1 : 0);
+    };
+
+    while (order.size() < triangleCount)
+    {
+        // the neighbor adding the fewest vertices, or the next unused triangle when there is none
+        unsigned int next = 0;
+        size_t best = 4;
+        size_t kept = 0, scanned = 0;
+        for (; scanned < candidates.size() && best > 0; scanned++)
+        {
+            unsigned int candidate = candidates[scanned];
+            if (emitted[candidate])
+                continue;
+            candidates[kept++] = candidate;
+            size_t added = newVertices(candidate);
+            if (added < best)
+            {
+                best = added;
+                next = candidate;
+            }
+        }
+        candidates.erase(candidates.begin() + kept, candidates.begin() + scanned);
+        if (best == 4)
+        {
+            while (emitted[seed])
+                seed++;
+            next = (unsigned int)seed;
+            best = newVertices(next);
+        }
+        if (meshletVertices + best > maxVertices || meshletTriangles + 1 > maxTriangles)
+        {
+            closeMeshlet();
+            continue;
+        }
+
+        emitted[next] = true;
+        order.push_back(next);
+        meshletVertices += best;
+        meshletTriangles++;
+        for (int corner = 0; corner < 3; corner++)
+        {
+            unsigned int v = indices[next * 3 + corner];
+            inMeshlet[v] = meshlets.size() + 1;
+            for (unsigned int i = adjacencyStart[v]; i < adjacencyStart[v + 1]; i++)
+                if (!emitted[adjacency[i]] && queuedFor[adjacency[i]] != meshlets.size() + 1)
+                {
+                    queuedFor[adjacency[i]] = meshlets.size() + 1;
+                    candidates.push_back(adjacency[i]);
+                }
+        }
+    }
+    closeMeshlet();
+
+    std::vector<unsigned int> reordered(triangleCount * 3);
+    for (size_t t = 0; t < triangleCount; t++)
+        for (int corner = 0; corner < 3; corner++)
+            reordered[t * 3 + corner] = indices[order[t] * 3 + corner];
+    std::copy(reordered.begin(), reordered.end(), indices);
+
+    for (size_t m = first; m < meshlets.size(); m++)
+        meshletBounds(meshlets[m], indices + meshlets[m].firstIndex, meshlets[m].indexCount, vertices, vertexStride);
+    return meshlets.size() - first;
+}
+#endif
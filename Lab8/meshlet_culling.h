@@ -0,0 +1,131 @@
+//
+//  meshlet_culling.h
+//  3D Object Drawing
+//
+//  CPU culling of a mesh file's meshlets (meshlet_builder.h) for one instance
+//  at a time: a meshlet is dropped when its bounding sphere is outside the
+//  camera frustum or its normal cone faces away from the camera, and the
+//  survivors are returned as runs of the index buffer, neighbors merged, for
+//  InstanceBatch to draw.
+//  Both tests run in the instance's model space: the frustum planes come from
+//  the full model-view-projection matrix and the camera is moved by the inverse
+//  model matrix, so the parts' non-uniform scales do not loosen the bounds.
+//
+//      MeshletCuller culler;
+//      culler.setView(frameUniforms.data);             // once per frame
+//      if (culler.cull(model, cubeMesh, lod, visible))
+//          batch.add(model, color, lod, visible.data(), visible.size());
+//
+
+#ifndef MESHLET_CULLING_H
+#define MESHLET_CULLING_H
+
+#include <glm/glm.hpp>
+
+#include "frame_data.h"
+#include "mesh_file.h"
+
+#include <vector>
+#include <cmath>
+
+class MeshletCuller
+{
+public:
+    // normal cone test on or off; it assumes back faces are never seen (closed or face-culled meshes)
+    bool coneCulling;
+
+    MeshletCuller() : coneCulling(true), viewProjection(1.0f), eye(0.0f), tested(0), frustumCulled(0), coneCulled(0) {}
+
+    // camera of the frame; also starts the per-frame counters over
+    // ------------------------------------------------------------------------
+    void setView(const FrameData& frame)
+    {
+        viewProjection = frame.viewProjection;
+        eye = glm::vec3(frame.cameraPosition);
+        tested = frustumCulled = coneCulled = 0;
+    }
+
+    // fill ranges with the visible index runs of lod for an instance drawn with model; false when
+    // none is visible. Without meshlets in the file the whole LOD is one visible run.
+    // ------------------------------------------------------------------------
+    bool cull(const glm::mat4& model, const MeshFile& mesh, unsigned int lod, std::vector<IndexRange>& ranges)
+    {
+        ranges.clear();
+        const MeshLOD& level = mesh.lods()[lod];
+        if (level.meshletCount == 0)
+        {
+            ranges.push_back({ level.firstIndex, level.indexCount });
+            return true;
+        }
+
+        // Gribb-Hartmann: left, right, bottom, top, near, far, in model space
+        glm::mat4 clip = viewProjection * model;
+        glm::vec4 planes[6];
+        for (int axis = 0; axis < 3; axis++)
+        {
+            glm::vec4 row(clip[0][axis], clip[1][axis], clip[2][axis], clip[3][axis]);
+            glm::vec4 w(clip[0][3], clip[1][3], clip[2][3], clip[3][3]);
+            planes[axis * 2] = w + row;
+            planes[axis * 2 + 1] = w - row;
+        }
+        for (glm::vec4& plane : planes)
+            plane /= glm::length(glm::vec3(plane));
+        glm::vec3 modelEye = glm::vec3(glm::inverse(model) * glm::vec4(eye, 1.0f));
+        // a mirroring model matrix turns the winding, and with it which side faces away
+        bool testCones = coneCulling && glm::determinant(glm::mat3(model)) > 0.0f;
+
+        const Meshlet* meshlets = mesh.meshlets() + level.firstMeshlet;
+        for (uint32_t i = 0; i < level.meshletCount; i++)
+        {
+            const Meshlet& meshlet = meshlets[i];
+            glm::vec3 center(meshlet.center[0], meshlet.center[1], meshlet.center[2]);
+            tested++;
+
+            bool outside = false;
+            for (const glm::vec4& plane : planes)
+                outside = outside || glm::dot(glm::vec3(plane), center) + plane.w < -meshlet.radius;
+            if (outside)
+            {
+                frustumCulled++;
+                continue;
+            }
+            // every triangle faces away when every direction from the camera into the sphere
+            // is within 90 degrees minus the cone's half angle of the axis
+            glm::vec3 toCenter = center - modelEye;
+            glm::vec3 axis(meshlet.coneAxis[0], meshlet.coneAxis[1], meshlet.coneAxis[2]);
+            if (testCones && glm::dot(toCenter, axis) >= meshlet.coneCutoff * glm::length(toCenter) + meshlet.radius)
+            {
+                coneCulled++;
+                continue;
+            }
+
+            if (!ranges.empty() && ranges.back().firstIndex + ranges.back().indexCount == meshlet.firstIndex)
+                ranges.back().indexCount += meshlet.indexCount;
+            else
+                ranges.push_back({ meshlet.firstIndex, meshlet.indexCount });
+        }
+        return !ranges.empty();
+    }
+
+    // meshlets tested since setView() and how many of them each test removed
+    size_t getTested() const
+    {
+        return tested;
+    }
+    size_t getFrustumCulled() const
+    {
+        return frustumCulled;
+    }
+    size_t getConeCulled() const
+    {
+        return coneCulled;
+    }
+
+private:
+    glm::mat4 viewProjection;
+    glm::vec3 eye;
+    size_t tested;
+    size_t frustumCulled;
+    size_t coneCulled;
+};
+#endif
@@ -0,0 +1,169 @@
+//
+//  program_cache.h
+//  3D Object Drawing
+//
+//  On-disk cache of linked program binaries (glGetProgramBinary / glProgramBinary).
+//  Entries are keyed on a hash of the shader sources plus the GL vendor, renderer
+//  and version strings, so a driver update simply misses the cache.
+//
+
+#ifndef PROGRAM_CACHE_H
+#define PROGRAM_CACHE_H
+
+#include <glad/glad.h>
+#include "gl_ext.h"
+#include "shader_source.h"
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <cstdint>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+class ProgramCache
+{
+public:
+    // directory the binaries are written to, relative to the working directory
+    static std::string& directory()
+    {
+        static std::string dir = "shader_cache";
+        return dir;
+    }
+
+    static bool available()
+    {
+        return glExt().programBinary;
+    }
+
+    // 64-bit FNV-1a over every stage source and the driver identification strings
+    // ------------------------------------------------------------------------
+    static uint64_t key(const std::vector<const ShaderSource*>& sources)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (const ShaderSource* source : sources)
+        {
+            hash = source->hash(hash);
+            hash = fnv1a(hash, "\0", 1);
+        }
+        const GLenum driverStrings[] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+        for (GLenum name : driverStrings)
+        {
+            const char* value = (const char*)glGetString(name);
+            if (value)
+                hash = fnv1a(hash, value, std::char_traits<char>::length(value));
+            hash = fnv1a(hash, "\0", 1);
+        }
+        return hash;
+    }
+
+    // hand a cached binary to the driver; false if there is no entry. Whether the driver accepted it is
+    // only known from GL_LINK_STATUS, which the caller reads once it waits on the program anyway
+    // ------------------------------------------------------------------------
+    static bool load(GLuint program, uint64_t key)
+    {
+        if (!available())
+            return false;
+        std::ifstream file(path(key), std::ios::binary);
+        if (!file)
+            return false;
+
+        FileHeader header;
+        if (!file.read((char*)&header, sizeof(header)) || header.magic != MAGIC || header.version != VERSION || header.key != key)
+            return false;
+        std::vector<char> binary(header.length);
+        if (!file.read(binary.data(), binary.size()))
+            return false;
+
+        glExt().ProgramBinary(program, header.format, binary.data(), (GLsizei)binary.size());
+        return true;
+    }
+
+    // drop an entry the driver rejected (stale or foreign binary) so a fresh one is stored
+    static void discard(uint64_t key)
+    {
+        std::remove(path(key).c_str());
+    }
+
+    // must be called before glLinkProgram for the driver to keep a retrievable binary
+    static void markRetrievable(GLuint program)
+    {
+        if (available())
+            glExt().ProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    // write the binary of a successfully linked program to the cache
+    // ------------------------------------------------------------------------
+    static void store(GLuint program, uint64_t key)
+    {
+        if (!available())
+            return;
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0)
+            return;
+
+        FileHeader header;
+        header.key = key;
+        std::vector<char> binary(length);
+        GLsizei written = 0;
+        glExt().GetProgramBinary(program, length, &written, &header.format, binary.data());
+        header.length = (uint32_t)written;
+
+        makeDirectory(directory());
+        std::ofstream file(path(key), std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            std::cout << "WARNING::PROGRAM_CACHE::CANNOT_WRITE: " << path(key) << std::endl;
+            return;
+        }
+        file.write((const char*)&header, sizeof(header));
+        file.write(binary.data(), written);
+    }
+
+private:
+    static const uint32_t MAGIC = 0x42504c47; // "GLPB"
+    static const uint32_t VERSION = 1;
+
+    struct FileHeader
+    {
+        uint32_t magic = MAGIC;
+        uint32_t version = VERSION;
+        uint64_t key = 0;
+        GLenum format = 0;
+        uint32_t length = 0;
+    };
+
+    static uint64_t fnv1a(uint64_t hash, const char* data, size_t size)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= (unsigned char)data[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    static std::string path(uint64_t key)
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+        return directory() + "/" + name;
+    }
+
+    static void makeDirectory(const std::string& dir)
+    {
+#ifdef _WIN32
+        _mkdir(dir.c_str());
+#else
+        mkdir(dir.c_str(), 0755);
+#endif
+    }
+};
+#endif
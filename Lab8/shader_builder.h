@@ -0,0 +1,109 @@
+//
+//  shader_builder.h
+//  3D Object Drawing
+//
+//  Submits the compile and link of several programs up front and defers every
+//  status query until a program is first used, so the driver can overlap the
+//  work (on its own threads when KHR_parallel_shader_compile is available).
+//
+//      ShaderBuilder builder;
+//      ProgramFuture cubeProgram = builder.add("vertexShader.vs", "fragmentShader.fs");
+//      builder.submit();
+//      ... other setup ...
+//      Shader& ourShader = cubeProgram.get();
+//
+
+#ifndef SHADER_BUILDER_H
+#define SHADER_BUILDER_H
+
+#include "shader.h"
+
+#include <memory>
+#include <vector>
+
+// handle to a program that may still be compiling
+class ProgramFuture
+{
+public:
+    ProgramFuture() {}
+
+    bool valid() const
+    {
+        return shader != nullptr;
+    }
+
+    // polls the driver; never blocks when KHR_parallel_shader_compile is available
+    bool ready() const
+    {
+        return shader->ID != 0 && shader->isReady();
+    }
+
+    // resolves the program on first use, blocking until the driver has linked it
+    // ------------------------------------------------------------------------
+    Shader& get()
+    {
+        // separable stages stay empty without separate shader objects; ProgramPipeline links them instead
+        if (shader->ID == 0 && (shader->separableStage == GL_NONE || glExt().separateShaderObjects))
+        {
+            // never submitted through the builder: compile just this one now
+            shader->compileStages();
+            shader->linkProgram();
+        }
+        if (shader->building)
+            shader->finishBuild();
+        return *shader;
+    }
+
+private:
+    friend class ShaderBuilder;
+    explicit ProgramFuture(const std::shared_ptr<Shader>& building) : shader(building) {}
+
+    std::shared_ptr<Shader> shader;
+};
+
+class ShaderBuilder
+{
+public:
+    // reads the sources now; nothing reaches the driver until submit()
+    // ------------------------------------------------------------------------
+    ProgramFuture add(const char* vertexPath, const char* fragmentPath, const std::vector<std::string>& defines = std::vector<std::string>())
+    {
+        std::shared_ptr<Shader> shader(new Shader());
+        shader->vertexDefines = shader->fragmentDefines = defines;
+        shader->readSources(vertexPath, fragmentPath);
+        queued.push_back(shader);
+        return ProgramFuture(shader);
+    }
+
+    // a separable stage for a ProgramPipeline (see Shader(GLenum, path))
+    // ------------------------------------------------------------------------
+    ProgramFuture addStage(GLenum stage, const char* path, const std::vector<std::string>& defines = std::vector<std::string>())
+    {
+        std::shared_ptr<Shader> shader(new Shader());
+        shader->vertexDefines = shader->fragmentDefines = defines;
+        shader->separableStage = stage;
+        shader->stagePath = path;
+        if (!glExt().separateShaderObjects)
+            return ProgramFuture(shader);
+        shader->readSources(stage == GL_VERTEX_SHADER ? path : nullptr, stage == GL_FRAGMENT_SHADER ? path : nullptr);
+        queued.push_back(shader);
+        return ProgramFuture(shader);
+    }
+
+    // queue every compile first and every link after, without waiting on any of them
+    // ------------------------------------------------------------------------
+    void submit()
+    {
+        for (const std::shared_ptr<Shader>& shader : queued)
+            if (shader->ID == 0)
+                shader->compileStages();
+        for (const std::shared_ptr<Shader>& shader : queued)
+            if (shader->building)
+                shader->linkProgram();
+        queued.clear();
+    }
+
+private:
+    std::vector<std::shared_ptr<Shader> > queued;
+};
+#endif
@@ -0,0 +1,214 @@
+//
+//  shader_pipeline.h
+//  3D Object Drawing
+//
+//  Program pipelines: every vertex and fragment stage is compiled and linked once
+//  as a separable program and the stages are combined at bind time, so N vertex
+//  by M fragment variants cost N + M links instead of N x M.
+//  Contexts without separate shader objects (plain 3.3) fall back to linking one
+//  complete program per pipeline from the stages' sources.
+//
+//      ShaderStages stages;
+//      Shader& vertex = stages.get(GL_VERTEX_SHADER, "vertexShader.vs");
+//      Shader& flat = stages.get(GL_FRAGMENT_SHADER, "fragmentShader.fs", { "FLAT_COLOR" });
+//      ProgramPipeline& pipeline = stages.pipeline(vertex, flat);
+//      Uniform<glm::mat4> model(pipeline.program(GL_VERTEX_SHADER), "model");
+//
+//      pipeline.bind();
+//      pipeline.activate(GL_VERTEX_SHADER);
+//      model.set(modelMatrix);
+//
+
+#ifndef SHADER_PIPELINE_H
+#define SHADER_PIPELINE_H
+
+#include "gl_ext.h"
+#include "gl_state.h"
+#include "shader.h"
+#include "shader_builder.h"
+#include "shader_variants.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <utility>
+#include <iostream>
+
+class ProgramPipeline
+{
+public:
+    // the stages must outlive the pipeline
+    ProgramPipeline(const Shader& vertexStage, const Shader& fragmentStage) : ID(0), vertex(&vertexStage), fragment(&fragmentStage), vertexProgram(0), fragmentProgram(0)
+    {
+        if (glExt().separateShaderObjects)
+        {
+            glExt().GenProgramPipelines(1, &ID);
+            attachStages();
+            validate();
+        }
+        else
+        {
+            combined.reset(new Shader());
+            combined->readSources(vertexStage, fragmentStage);
+            combined->compileStages();
+            combined->linkProgram();
+            combined->finishBuild();
+        }
+    }
+
+    ~ProgramPipeline()
+    {
+        if (ID)
+            glExt().DeleteProgramPipelines(1, &ID);
+    }
+
+    ProgramPipeline(const ProgramPipeline&) = delete;
+    ProgramPipeline& operator=(const ProgramPipeline&) = delete;
+
+    // make the pipeline current; stages whose program was replaced by a hot reload are re-attached here
+    // ------------------------------------------------------------------------
+    void bind() const
+    {
+        if (combined)
+        {
+            combined->use();
+            return;
+        }
+        attachStages();
+        // a program made current with glUseProgram takes precedence over the bound pipeline
+        glState().useProgram(0);
+        glState().bindProgramPipeline(ID);
+    }
+
+    // the Shader holding the uniforms of a stage: the separable stage itself, or the combined program
+    // ------------------------------------------------------------------------
+    const Shader& program(GLenum stage) const
+    {
+        if (combined)
+            return *combined;
+        return stage == GL_VERTEX_SHADER ? *vertex : *fragment;
+    }
+
+    // route glUniform* (Shader::set*, Uniform<T>::set) to the program of a stage; the pipeline must be bound
+    // ------------------------------------------------------------------------
+    void activate(GLenum stage) const
+    {
+        if (!combined)
+            glExt().ActiveShaderProgram(ID, program(stage).ID);
+    }
+
+    // checks that the stages fit together (matching interfaces); prints the driver's log if not
+    // ------------------------------------------------------------------------
+    bool validate() const
+    {
+        if (combined)
+            return combined->ID != 0;
+        attachStages();
+        glExt().ValidateProgramPipeline(ID);
+        GLint success = GL_FALSE;
+        glExt().GetProgramPipelineiv(ID, GL_VALIDATE_STATUS, &success);
+        if (!success)
+        {
+            GLchar infoLog[1024];
+            glExt().GetProgramPipelineInfoLog(ID, 1024, NULL, infoLog);
+            std::cout << "ERROR::PROGRAM_PIPELINE_VALIDATION_ERROR\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
+        }
+        return success != 0;
+    }
+
+    // true when the stages were linked into one program because separate shader objects are missing
+    bool isCombined() const
+    {
+        return combined != nullptr;
+    }
+    // that combined program, or null; the stages have no program of their own then, so hot reload
+    // (ShaderWatcher::watch(shader, vertexPath, fragmentPath)) has to follow this one instead
+    Shader* combinedProgram()
+    {
+        return combined.get();
+    }
+
+private:
+    unsigned int ID;
+    const Shader* vertex;
+    const Shader* fragment;
+    // stage programs currently attached to the pipeline object
+    mutable unsigned int vertexProgram;
+    mutable unsigned int fragmentProgram;
+    std::unique_ptr<Shader> combined;
+
+    void attachStages() const
+    {
+        if (vertex->ID != vertexProgram)
+        {
+            glExt().UseProgramStages(ID, GL_VERTEX_SHADER_BIT, vertex->ID);
+            vertexProgram = vertex->ID;
+        }
+        if (fragment->ID != fragmentProgram)
+        {
+            glExt().UseProgramStages(ID, GL_FRAGMENT_SHADER_BIT, fragment->ID);
+            fragmentProgram = fragment->ID;
+        }
+    }
+};
+
+// a library of separable stages, a ShaderVariants cache per stage file, and the pipelines combining them
+class ShaderStages
+{
+public:
+    ShaderStages() : links(0) {}
+
+    // queue a stage on a builder so it compiles together with the other programs
+    // ------------------------------------------------------------------------
+    void prepare(ShaderBuilder& builder, GLenum stage, const char* path, const std::vector<std::string>& defines)
+    {
+        variantsOf(stage, path).prepare(builder, defines);
+    }
+
+    // the stage for a file and define set, built on first request
+    // ------------------------------------------------------------------------
+    Shader& get(GLenum stage, const char* path, const std::vector<std::string>& defines = std::vector<std::string>())
+    {
+        return variantsOf(stage, path).get(defines);
+    }
+
+    // the pipeline combining two stages, created on first request; never relinks the stages
+    // ------------------------------------------------------------------------
+    ProgramPipeline& pipeline(const Shader& vertex, const Shader& fragment)
+    {
+        std::unique_ptr<ProgramPipeline>& pipeline = pipelines[std::make_pair(&vertex, &fragment)];
+        if (!pipeline)
+        {
+            pipeline.reset(new ProgramPipeline(vertex, fragment));
+            if (pipeline->isCombined())
+                links++;
+        }
+        return *pipeline;
+    }
+
+    // programs linked so far: one per stage, plus one per pipeline when stages cannot be separated
+    unsigned int linkCount() const
+    {
+        unsigned int count = links;
+        if (glExt().separateShaderObjects)
+            for (const auto& variants : stages)
+                count += (unsigned int)variants.second->size();
+        return count;
+    }
+
+private:
+    std::map<std::pair<GLenum, std::string>, std::unique_ptr<ShaderVariants> > stages;
+    std::map<std::pair<const Shader*, const Shader*>, std::unique_ptr<ProgramPipeline> > pipelines;
+    // combined programs linked because stages cannot be separated
+    unsigned int links;
+
+    ShaderVariants& variantsOf(GLenum stage, const char* path)
+    {
+        std::unique_ptr<ShaderVariants>& variants = stages[std::make_pair(stage, std::string(path))];
+        if (!variants)
+            variants.reset(new ShaderVariants(stage, path));
+        return *variants;
+    }
+};
+#endif
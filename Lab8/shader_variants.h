@@ -0,0 +1,80 @@
+//
+//  shader_variants.h
+//  3D Object Drawing
+//
+//  Compiled permutations of one vertex/fragment pair, keyed by their define set.
+//  Each permutation is built once; callers pick a variant instead of switching
+//  behaviour with a uniform inside the shader.
+//  Built for one stage file, the permutations are separable stages instead,
+//  which ShaderStages (shader_pipeline.h) combines into program pipelines.
+//
+//      ShaderVariants cubeShaders("vertexShader.vs", "fragmentShader.fs");
+//      Shader& flatColor = cubeShaders.get({ "FLAT_COLOR" });
+//
+//      ShaderVariants fragmentStages(GL_FRAGMENT_SHADER, "fragmentShader.fs");
+//      Shader& flatStage = fragmentStages.get({ "FLAT_COLOR" });
+//
+
+#ifndef SHADER_VARIANTS_H
+#define SHADER_VARIANTS_H
+
+#include "shader.h"
+#include "shader_builder.h"
+#include "shader_preprocessor.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+class ShaderVariants
+{
+public:
+    ShaderVariants(const char* vertex, const char* fragment) : stage(GL_NONE), vertexPath(vertex), fragmentPath(fragment) {}
+    // permutations of a single separable stage, GL_VERTEX_SHADER or GL_FRAGMENT_SHADER
+    ShaderVariants(GLenum separableStage, const char* path)
+        : stage(separableStage), vertexPath(separableStage == GL_VERTEX_SHADER ? path : ""), fragmentPath(separableStage == GL_FRAGMENT_SHADER ? path : "") {}
+
+    // queue a permutation on a builder so it compiles together with the other programs
+    // ------------------------------------------------------------------------
+    void prepare(ShaderBuilder& builder, const std::vector<std::string>& defines)
+    {
+        std::string key = ShaderPreprocessor::defineKey(defines);
+        if (variants.find(key) == variants.end())
+            variants[key] = add(builder, defines);
+    }
+
+    // the program for a define set, built on first request
+    // ------------------------------------------------------------------------
+    Shader& get(const std::vector<std::string>& defines = std::vector<std::string>())
+    {
+        std::string key = ShaderPreprocessor::defineKey(defines);
+        std::map<std::string, ProgramFuture>::iterator it = variants.find(key);
+        if (it == variants.end())
+        {
+            ShaderBuilder builder;
+            it = variants.insert(std::make_pair(key, add(builder, defines))).first;
+            builder.submit();
+        }
+        return it->second.get();
+    }
+
+    size_t size() const
+    {
+        return variants.size();
+    }
+
+private:
+    // GL_NONE for complete programs
+    GLenum stage;
+    std::string vertexPath;
+    std::string fragmentPath;
+    std::map<std::string, ProgramFuture> variants;
+
+    ProgramFuture add(ShaderBuilder& builder, const std::vector<std::string>& defines)
+    {
+        if (stage == GL_NONE)
+            return builder.add(vertexPath.c_str(), fragmentPath.c_str(), defines);
+        return builder.addStage(stage, stage == GL_VERTEX_SHADER ? vertexPath.c_str() : fragmentPath.c_str(), defines);
+    }
+};
+#endif
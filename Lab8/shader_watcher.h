@@ -0,0 +1,344 @@
+//
+//  shader_watcher.h
+//  3D Object Drawing
+//
+//  Hot-reloads shader files while the program runs. A background thread waits
+//  for changes (inotify on Linux, modification-time polling elsewhere) and reads
+//  the new sources; update(), called once per frame from the GL thread, submits
+//  the rebuild and swaps the new program into the Shader only after it linked.
+//  A broken edit is reported and the old program keeps running.
+//
+//  Only with KHR_parallel_shader_compile is the reload free of hitches: the
+//  driver compiles on its own threads and the status is read once it reports
+//  completion. Plain 3.3 has no way to ask, so the fallback waits a few frames
+//  and then reads the compile and link status on the render thread, which
+//  stalls that frame for whatever compile work the driver has not finished.
+//
+
+#ifndef SHADER_WATCHER_H
+#define SHADER_WATCHER_H
+
+#include "shader.h"
+#include "shader_preprocessor.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+
+#include <sys/stat.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+class ShaderWatcher
+{
+public:
+    ShaderWatcher() : running(false)
+    {
+#ifdef __linux__
+        inotifyFd = inotify_init1(IN_NONBLOCK);
+        if (inotifyFd < 0)
+            std::cout << "ERROR::SHADER_WATCHER::INOTIFY_INIT_FAILED" << std::endl;
+#endif
+    }
+
+    // no GL calls here: the context is usually gone by now, see clear()
+    ~ShaderWatcher()
+    {
+        stop();
+#ifdef __linux__
+        for (int wd : watches)
+            inotify_rm_watch(inotifyFd, wd);
+        if (inotifyFd >= 0)
+            close(inotifyFd);
+#endif
+    }
+
+    // register a shader for reloading; its files are watched from this call on, also after the first update()
+    // ------------------------------------------------------------------------
+    void watch(Shader& shader, const char* vertexPath, const char* fragmentPath)
+    {
+        std::unique_ptr<Entry> entry(new Entry());
+        entry->shader = &shader;
+        entry->vertexPath = vertexPath;
+        entry->fragmentPath = fragmentPath;
+        entry->vertexDefines = shader.vertexDefines;
+        entry->fragmentDefines = shader.fragmentDefines;
+        entry->files = shader.sourceFiles;
+        if (entry->files.empty())
+            for (const std::string& path : { entry->vertexPath, entry->fragmentPath })
+                if (!path.empty())
+                    entry->files.push_back(path);
+        for (const std::string& file : entry->files)
+            entry->times.push_back(modifiedTime(file));
+        std::lock_guard<std::mutex> lock(mutex);
+        addWatches(*entry);
+        entries.push_back(std::move(entry));
+    }
+    // a separable stage built with Shader(GLenum, path); pipelines using it pick up the new program on their next bind()
+    void watch(Shader& stage, const char* path)
+    {
+        // without separate shader objects the stage has no program of its own to replace
+        if (stage.ID == 0)
+            return;
+        watch(stage, stage.separableStage == GL_VERTEX_SHADER ? path : "", stage.separableStage == GL_FRAGMENT_SHADER ? path : "");
+    }
+
+    // call once per frame on the GL thread, at the frame boundary; waits on the compiler only on
+    // the fallback path without KHR_parallel_shader_compile (see the top of the file)
+    // ------------------------------------------------------------------------
+    void update()
+    {
+        if (!running)
+            start();
+
+        for (std::unique_ptr<Entry>& entry : entries)
+        {
+            if (entry->candidate)
+            {
+                entry->framesInFlight++;
+                // without KHR_parallel_shader_compile isReady() cannot tell, so give the driver a couple of
+                // frames; finishBuild() then blocks until the compile and link are really done
+                bool done = glExt().parallelShaderCompile ? entry->candidate->isReady() : entry->framesInFlight > 2;
+                if (!done)
+                    continue;
+                if (entry->candidate->finishBuild())
+                {
+                    entry->shader->replaceProgram(*entry->candidate);
+                    std::cout << "SHADER::RELOADED: " << entry->vertexPath << ", " << entry->fragmentPath << std::endl;
+                }
+                else
+                {
+                    std::cout << "SHADER::RELOAD_FAILED, keeping the previous program: " << entry->vertexPath << ", " << entry->fragmentPath << std::endl;
+                    glDeleteProgram(entry->candidate->ID);
+                }
+                entry->candidate.reset();
+                continue;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!entry->changed)
+                    continue;
+                entry->candidate.reset(new Shader());
+                entry->candidate->separableStage = entry->shader->separableStage;
+                entry->candidate->vertexSource = std::move(entry->vertexSource);
+                entry->candidate->fragmentSource = std::move(entry->fragmentSource);
+                entry->changed = false;
+            }
+            entry->candidate->compileStages();
+            entry->candidate->linkProgram();
+            entry->framesInFlight = 0;
+        }
+    }
+
+    void stop()
+    {
+        if (!running)
+            return;
+        running = false;
+        if (thread.joinable())
+            thread.join();
+    }
+
+    // stop watching and delete the rebuilds still in flight; call while the context is still current
+    // ------------------------------------------------------------------------
+    void clear()
+    {
+        stop();
+        for (std::unique_ptr<Entry>& entry : entries)
+        {
+            if (entry->candidate && entry->candidate->ID)
+                glDeleteProgram(entry->candidate->ID);
+            entry->candidate.reset();
+        }
+    }
+
+private:
+    struct Entry
+    {
+        Shader* shader = nullptr;
+        std::string vertexPath;
+        std::string fragmentPath;
+        // each file is preprocessed with its own stage's set, as the Shader was
+        std::vector<std::string> vertexDefines;
+        std::vector<std::string> fragmentDefines;
+        // every file the sources were built from (includes too); only touched by the watcher thread once registered
+        std::vector<std::string> files;
+        std::vector<long long> times;
+        // written by the watcher thread, guarded by mutex
+        bool changed = false;
+        ShaderSource vertexSource;
+        ShaderSource fragmentSource;
+        // rebuild in flight, owned by the GL thread
+        std::unique_ptr<Shader> candidate;
+        int framesInFlight = 0;
+    };
+
+    // the list itself is guarded by mutex; watch() may add to it while the watcher thread runs
+    std::vector<std::unique_ptr<Entry> > entries;
+    std::thread thread;
+    std::mutex mutex;
+    std::atomic<bool> running;
+#ifdef __linux__
+    int inotifyFd;
+    // one per watched directory, guarded by mutex
+    std::vector<int> watches;
+#endif
+
+    void start()
+    {
+        running = true;
+        thread = std::thread(&ShaderWatcher::run, this);
+    }
+
+    // watch the directories of an entry's files (all of them, so editors that save by rename are seen too);
+    // the caller holds mutex
+    void addWatches(const Entry& entry)
+    {
+#ifdef __linux__
+        if (inotifyFd < 0)
+            return;
+        for (const std::string& path : entry.files)
+        {
+            int wd = inotify_add_watch(inotifyFd, directoryOf(path).c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+            if (wd >= 0 && std::find(watches.begin(), watches.end(), wd) == watches.end())
+                watches.push_back(wd);
+        }
+#else
+        (void)entry;
+#endif
+    }
+
+    // the registered entries; Entry objects stay put while the list grows
+    std::vector<Entry*> snapshot()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<Entry*> list;
+        for (std::unique_ptr<Entry>& entry : entries)
+            list.push_back(entry.get());
+        return list;
+    }
+
+    static long long modifiedTime(const std::string& path)
+    {
+#ifdef _WIN32
+        struct _stat info;
+        if (_stat(path.c_str(), &info) != 0)
+            return 0;
+#else
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0)
+            return 0;
+#endif
+        return (long long)info.st_mtime;
+    }
+
+    static std::string fileName(const std::string& path)
+    {
+        size_t slash = path.find_last_of("/\\");
+        return slash == std::string::npos ? path : path.substr(slash + 1);
+    }
+
+    static std::string directoryOf(const std::string& path)
+    {
+        size_t slash = path.find_last_of("/\\");
+        return slash == std::string::npos ? std::string(".") : path.substr(0, slash);
+    }
+
+    // re-run the preprocessor for an entry on the watcher thread and hand the sources to update()
+    // ------------------------------------------------------------------------
+    void reload(Entry& entry)
+    {
+        // editors often truncate then write; give them a moment to finish
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        ShaderSource vertexSource, fragmentSource;
+        // separable stages have only one of the two paths
+        if ((!entry.vertexPath.empty() && !ShaderPreprocessor::load(entry.vertexPath, entry.vertexDefines, vertexSource)) ||
+            (!entry.fragmentPath.empty() && !ShaderPreprocessor::load(entry.fragmentPath, entry.fragmentDefines, fragmentSource)))
+            return;
+        // includes may have changed with the edit
+        entry.files = vertexSource.files;
+        entry.files.insert(entry.files.end(), fragmentSource.files.begin(), fragmentSource.files.end());
+        entry.times.clear();
+        for (const std::string& file : entry.files)
+            entry.times.push_back(modifiedTime(file));
+        std::lock_guard<std::mutex> lock(mutex);
+        addWatches(entry);
+        entry.vertexSource = std::move(vertexSource);
+        entry.fragmentSource = std::move(fragmentSource);
+        entry.changed = true;
+    }
+
+#ifdef __linux__
+    // wait for events on the directories watch() registered
+    // ------------------------------------------------------------------------
+    void run()
+    {
+        if (inotifyFd < 0)
+            return;
+        alignas(inotify_event) char buffer[4096];
+        while (running)
+        {
+            pollfd descriptor = { inotifyFd, POLLIN, 0 };
+            if (poll(&descriptor, 1, 200) <= 0)
+                continue;
+            ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+            std::vector<Entry*> registered = snapshot();
+            std::vector<Entry*> touched;
+            for (ssize_t offset = 0; offset < length;)
+            {
+                const inotify_event* event = (const inotify_event*)(buffer + offset);
+                offset += sizeof(inotify_event) + event->len;
+                if (event->len == 0)
+                    continue;
+                std::string name = event->name;
+                for (Entry* entry : registered)
+                    for (const std::string& file : entry->files)
+                        if (fileName(file) == name)
+                        {
+                            touched.push_back(entry);
+                            break;
+                        }
+            }
+            for (size_t i = 0; i < touched.size(); i++)
+                if (std::find(touched.begin(), touched.begin() + i, touched[i]) == touched.begin() + i)
+                    reload(*touched[i]);
+        }
+    }
+#else
+    // no inotify: poll modification times a few times per second
+    // ------------------------------------------------------------------------
+    void run()
+    {
+        while (running)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(250));
+            for (Entry* entry : snapshot())
+            {
+                bool changed = false;
+                for (size_t i = 0; i < entry->files.size(); i++)
+                {
+                    long long time = modifiedTime(entry->files[i]);
+                    if (time != entry->times[i])
+                    {
+                        entry->times[i] = time;
+                        changed = true;
+                    }
+                }
+                if (changed)
+                    reload(*entry);
+            }
+        }
+    }
+#endif
+};
+#endif
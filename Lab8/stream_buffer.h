@@ -0,0 +1,228 @@
+//
+//  stream_buffer.h
+//  3D Object Drawing
+//
+//  Ring buffer for data rewritten every frame (uniform blocks, debug lines,
+//  particles). With ARB_buffer_storage the whole ring is mapped once,
+//  persistently and coherently, and split into FRAMES regions; each frame writes
+//  straight into its own region, and a fence per region keeps the CPU from
+//  overwriting data the GPU has not read yet. Without it the buffer is orphaned
+//  every frame and the written ranges are mapped unsynchronized.
+//
+//      stream.nextFrame();
+//      GLintptr offset;
+//      LineVertex* lines = stream.allocate<LineVertex>(count, offset);
+//      ... fill lines ...
+//      stream.flush();                     // before drawing from it
+//      glDrawArrays(GL_LINES, offset / sizeof(LineVertex), count);
+//
+
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+
+#include <glad/glad.h>
+#include "gl_ext.h"
+#include "gl_state.h"
+
+#include <iostream>
+
+class StreamBuffer
+{
+public:
+    // frames the CPU may run ahead of the GPU
+    static const int FRAMES = 3;
+
+    // totals since the buffer was created
+    struct Stats
+    {
+        unsigned int bytes = 0;
+        // nextFrame() calls that had to block on the GPU
+        unsigned int waits = 0;
+        // allocations that did not fit the region
+        unsigned int overflows = 0;
+    };
+
+    // regionBytes is the most one frame may write, padding for alignment included
+    explicit StreamBuffer(size_t regionBytes) : buffer(0), regionSize(regionBytes), region(0), head(0), base(nullptr), mapped(nullptr), mappedOffset(0)
+    {
+        for (int i = 0; i < FRAMES; i++)
+            fences[i] = 0;
+        persistent = glExt().bufferStorage;
+
+        glGenBuffers(1, &buffer);
+        glState().bindBuffer(GL_ARRAY_BUFFER, buffer);
+        if (persistent)
+        {
+            const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glExt().BufferStorage(GL_ARRAY_BUFFER, FRAMES * regionSize, NULL, flags);
+            base = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, FRAMES * regionSize, flags);
+            if (!base)
+            {
+                // immutable storage cannot be respecified, so fall back with a fresh buffer
+                std::cout << "ERROR::STREAM_BUFFER::PERSISTENT_MAP_FAILED" << std::endl;
+                glState().deleteBuffer(buffer);
+                glGenBuffers(1, &buffer);
+                glState().bindBuffer(GL_ARRAY_BUFFER, buffer);
+                persistent = false;
+            }
+        }
+        if (!persistent)
+            glBufferData(GL_ARRAY_BUFFER, regionSize, NULL, GL_STREAM_DRAW);
+    }
+
+    ~StreamBuffer()
+    {
+        clear();
+    }
+
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    // call once per frame before the first allocate(): fences the frame just
+    // submitted and moves on to the oldest region, waiting for the GPU if needed
+    // ------------------------------------------------------------------------
+    void nextFrame()
+    {
+        flush();
+        if (persistent)
+        {
+            if (head > 0)
+                fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            region = (region + 1) % FRAMES;
+            waitFor(fences[region]);
+        }
+        else if (head > 0)
+        {
+            // orphan: the driver hands out fresh storage while the GPU keeps reading the old one
+            glState().bindBuffer(GL_ARRAY_BUFFER, buffer);
+            glBufferData(GL_ARRAY_BUFFER, regionSize, NULL, GL_STREAM_DRAW);
+        }
+        head = 0;
+    }
+
+    // bytes of writable memory in this frame's region and their offset in getBuffer(),
+    // or nullptr if the region is full; alignment must be a power of two
+    // ------------------------------------------------------------------------
+    void* allocate(size_t bytes, size_t alignment, GLintptr& offset)
+    {
+        // align the offset in the buffer, not in the region: regionSize need not be a multiple of alignment
+        size_t start = ((regionStart() + head + alignment - 1) & ~(alignment - 1)) - regionStart();
+        if (start + bytes > regionSize)
+        {
+            stats.overflows++;
+            std::cout << "ERROR::STREAM_BUFFER::REGION_FULL " << bytes << " bytes requested, " << regionSize - head << " left" << std::endl;
+            return nullptr;
+        }
+        head = start + bytes;
+        stats.bytes += (unsigned int)bytes;
+        offset = (GLintptr)(regionStart() + start);
+        if (persistent)
+            return base + offset;
+
+        // map from start to the end of the region: nothing there has been drawn from since the orphan
+        if (!mapped)
+        {
+            glState().bindBuffer(GL_ARRAY_BUFFER, buffer);
+            mappedOffset = start;
+            const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+            mapped = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, start, regionSize - start, flags);
+            if (!mapped)
+            {
+                std::cout << "ERROR::STREAM_BUFFER::MAP_FAILED" << std::endl;
+                return nullptr;
+            }
+        }
+        return mapped + (start - mappedOffset);
+    }
+    template <typename T>
+    T* allocate(size_t count, GLintptr& offset)
+    {
+        return (T*)allocate(count * sizeof(T), alignof(T), offset);
+    }
+
+    // make everything allocated so far visible to draws; the coherent mapping needs nothing
+    // ------------------------------------------------------------------------
+    void flush()
+    {
+        if (!mapped)
+            return;
+        glState().bindBuffer(GL_ARRAY_BUFFER, buffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        mapped = nullptr;
+    }
+
+    GLuint getBuffer() const
+    {
+        return buffer;
+    }
+    bool isPersistent() const
+    {
+        return persistent;
+    }
+    const Stats& getStats() const
+    {
+        return stats;
+    }
+
+    // delete the GL objects; call while the context is still current
+    // ------------------------------------------------------------------------
+    void clear()
+    {
+        for (int i = 0; i < FRAMES; i++)
+        {
+            if (fences[i])
+                glDeleteSync(fences[i]);
+            fences[i] = 0;
+        }
+        if (buffer)
+        {
+            // deleting the buffer unmaps it, persistent or not
+            glState().deleteBuffer(buffer);
+        }
+        buffer = 0;
+        base = mapped = nullptr;
+    }
+
+private:
+    GLuint buffer;
+    size_t regionSize;
+    bool persistent;
+    int region;
+    // next free byte of the current region
+    size_t head;
+    // persistent mapping of the whole ring
+    unsigned char* base;
+    // fallback mapping of [mappedOffset, regionSize) until flush()
+    unsigned char* mapped;
+    size_t mappedOffset;
+    GLsync fences[FRAMES];
+    Stats stats;
+
+    size_t regionStart() const
+    {
+        return persistent ? region * regionSize : 0;
+    }
+
+    void waitFor(GLsync& fence)
+    {
+        if (!fence)
+            return;
+        GLenum result = glClientWaitSync(fence, 0, 0);
+        if (result == GL_TIMEOUT_EXPIRED)
+        {
+            stats.waits++;
+            // the first wait flushes so the fence is guaranteed to signal
+            GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+            do
+            {
+                result = glClientWaitSync(fence, flags, 1000000);   // 1 ms
+                flags = 0;
+            } while (result == GL_TIMEOUT_EXPIRED);
+        }
+        if (result == GL_WAIT_FAILED)
+            std::cout << "ERROR::STREAM_BUFFER::WAIT_FAILED" << std::endl;
+        glDeleteSync(fence);
+        fence = 0;
+    }
+};
+#endif
@@ -0,0 +1,778 @@
+//
+//  glsl_optimize.cpp
+//  3D Object Drawing
+//
+//  Offline pass over shipped shaders, run before they are handed to Shader:
+//   - expands #include and resolves #ifdef/#ifndef/#if defined(...) for a define set,
+//     so only the selected variant is left
+//   - inlines uniforms given as constants (--const NAME=VALUE)
+//   - folds constant comparisons, !, && / ||, ?: and if/else on literal conditions
+//   - strips comments, unused uniforms/constants and functions nothing calls
+//  The result is written next to the original, named after the define set and the constants
+//  (fragmentShader.fs -> fragmentShader.FLAT_COLOR.opt.fs, old.fs --const changeColorFromMain=true
+//  -> old.changeColorFromMain=true.opt.fs) together with a size / statement-count report.
+//
+//      glsl_optimize fragmentShader.fs -D FLAT_COLOR
+//      glsl_optimize old.fs --const changeColorFromMain=true
+//
+//  It is a token-level pass, not a full GLSL compiler: anything it cannot prove
+//  (e.g. an #if expression it does not understand) is left untouched.
+//
+
+#include <cstdio>
+#include <cctype>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+struct Token
+{
+    enum Kind { DIRECTIVE, IDENTIFIER, NUMBER, PUNCT } kind;
+    std::string text;
+};
+
+static bool readFile(const std::string& path, std::string& text)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+    std::stringstream stream;
+    stream << file.rdbuf();
+    text = stream.str();
+    return true;
+}
+
+static std::string directoryOf(const std::string& path)
+{
+    size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+}
+
+// drop // and /* */ comments, keeping line structure for the directives
+static std::string stripComments(const std::string& text)
+{
+    std::string out;
+    for (size_t i = 0; i < text.size(); i++)
+    {
+        if (text.compare(i, 2, "//") == 0)
+        {
+            while (i < text.size() && text[i] != '\n')
+                i++;
+            out += '\n';
+        }
+        else if (text.compare(i, 2, "/*") == 0)
+        {
+            size_t end = text.find("*/", i + 2);
+            for (size_t j = i; j < (end == std::string::npos ? text.size() : end); j++)
+                if (text[j] == '\n')
+                    out += '\n';
+            i = end == std::string::npos ? text.size() : end + 1;
+        }
+        else if (text[i] != '\r')
+            out += text[i];
+    }
+    return out;
+}
+
+static std::vector<std::string> splitLines(const std::string& text)
+{
+    std::vector<std::string> lines;
+    std::istringstream stream(text);
+    std::string line;
+    while (std::getline(stream, line))
+        lines.push_back(line);
+    return lines;
+}
+
+static std::string trim(const std::string& s)
+{
+    size_t begin = s.find_first_not_of(" \t");
+    if (begin == std::string::npos)
+        return std::string();
+    size_t end = s.find_last_not_of(" \t");
+    return s.substr(begin, end - begin + 1);
+}
+
+// ------------------------------------------------------------------------
+// preprocessor: includes and conditionals
+// ------------------------------------------------------------------------
+
+class Preprocessor
+{
+public:
+    std::map<std::string, std::string> defines;
+
+    bool run(const std::string& path, std::vector<std::string>& out)
+    {
+        std::string text;
+        if (!readFile(path, text))
+        {
+            std::cout << "ERROR::GLSL_OPTIMIZE::FILE_NOT_SUCCESSFULLY_READ: " << path << std::endl;
+            return false;
+        }
+        included.insert(path);
+        std::vector<std::string> lines = splitLines(stripComments(text));
+        for (const std::string& raw : lines)
+        {
+            std::string line = trim(raw);
+            if (line.empty() || line[0] != '#')
+            {
+                if (active())
+                    out.push_back(raw);
+                continue;
+            }
+            std::string directive, rest;
+            splitDirective(line, directive, rest);
+
+            if (directive == "ifdef" || directive == "ifndef" || directive == "if")
+            {
+                int value = -1;
+                if (directive == "ifdef")
+                    value = defines.count(rest) ? 1 : 0;
+                else if (directive == "ifndef")
+                    value = defines.count(rest) ? 0 : 1;
+                else
+                    value = evaluate(rest);
+                Frame frame;
+                frame.parentActive = active();
+                frame.state = value < 0 ? UNKNOWN : (value ? TAKEN : PENDING);
+                stack.push_back(frame);
+                if (frame.parentActive && frame.state == UNKNOWN)
+                    out.push_back(raw);
+            }
+            else if (directive == "elif" || directive == "else")
+            {
+                if (stack.empty())
+                    continue;
+                Frame& frame = stack.back();
+                if (frame.state == UNKNOWN)
+                {
+                    if (frame.parentActive)
+                        out.push_back(raw);
+                }
+                else if (frame.state == TAKEN || frame.state == DONE)
+                    frame.state = DONE;
+                else
+                {
+                    int value = directive == "else" ? 1 : evaluate(rest);
+                    if (value < 0)
+                    {
+                        // cannot decide a later branch: hand the rest of the chain to the driver
+                        frame.state = UNKNOWN;
+                        if (frame.parentActive)
+                            out.push_back("#if " + rest);
+                    }
+                    else
+                        frame.state = value ? TAKEN : PENDING;
+                }
+            }
+            else if (directive == "endif")
+            {
+                if (stack.empty())
+                    continue;
+                if (stack.back().state == UNKNOWN && stack.back().parentActive)
+                    out.push_back(raw);
+                stack.pop_back();
+            }
+            else if (!active())
+                continue;
+            else if (directive == "include")
+            {
+                size_t open = rest.find_first_of("\"<");
+                size_t close = rest.find_first_of("\">", open + 1);
+                std::string file = directoryOf(path) + rest.substr(open + 1, close - open - 1);
+                if (!included.count(file) && !run(file, out))
+                    return false;
+            }
+            else if (directive == "define")
+            {
+                std::string name, value;
+                splitDirective("#" + rest, name, value);
+                defines[name] = value;
+                out.push_back(raw);
+            }
+            else if (directive == "undef")
+            {
+                defines.erase(rest);
+                out.push_back(raw);
+            }
+            else if (directive != "line")
+                out.push_back(raw);
+        }
+        return true;
+    }
+
+private:
+    enum State { TAKEN, PENDING, DONE, UNKNOWN };
+    struct Frame
+    {
+        bool parentActive;
+        State state;
+    };
+    std::vector<Frame> stack;
+    std::set<std::string> included;
+
+    bool active() const
+    {
+        for (const Frame& frame : stack)
+            if (frame.state == PENDING || frame.state == DONE)
+                return false;
+        return true;
+    }
+
+    static void splitDirective(const std::string& line, std::string& directive, std::string& rest)
+    {
+        size_t begin = line.find_first_not_of(" \t", 1);
+        size_t end = line.find_first_of(" \t", begin);
+        directive = begin == std::string::npos ? std::string() : line.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+        rest = end == std::string::npos ? std::string() : trim(line.substr(end));
+    }
+
+    // 1/0 for "defined(X)", "!defined X", "0", "1" and "||"/"&&" chains of those; -1 if unknown
+    int evaluate(const std::string& expression)
+    {
+        std::string e;
+        for (char c : expression)
+            if (c != ' ' && c != '\t')
+                e += c;
+        size_t split = e.find("||");
+        if (split != std::string::npos)
+        {
+            int a = evaluate(e.substr(0, split)), b = evaluate(e.substr(split + 2));
+            return (a == 1 || b == 1) ? 1 : (a == 0 && b == 0 ? 0 : -1);
+        }
+        split = e.find("&&");
+        if (split != std::string::npos)
+        {
+            int a = evaluate(e.substr(0, split)), b = evaluate(e.substr(split + 2));
+            return (a == 0 || b == 0) ? 0 : (a == 1 && b == 1 ? 1 : -1);
+        }
+        if (!e.empty() && e[0] == '!')
+        {
+            int a = evaluate(e.substr(1));
+            return a < 0 ? -1 : !a;
+        }
+        if (e.compare(0, 7, "defined") == 0)
+        {
+            std::string name = e.substr(7);
+            if (!name.empty() && name[0] == '(' && name[name.size() - 1] == ')')
+                name = name.substr(1, name.size() - 2);
+            return defines.count(name) ? 1 : 0;
+        }
+        if (e == "0" || e == "1")
+            return e == "1";
+        std::map<std::string, std::string>::const_iterator it = defines.find(e);
+        if (it != defines.end() && (it->second == "0" || it->second == "1"))
+            return it->second == "1";
+        return -1;
+    }
+};
+
+// ------------------------------------------------------------------------
+// tokens
+// ------------------------------------------------------------------------
+
+static std::vector<Token> tokenize(const std::vector<std::string>& lines)
+{
+    static const char* const operators[] = { "==", "!=", "<=", ">=", "&&", "||", "^^", "++", "--", "+=", "-=", "*=", "/=", "<<", ">>" };
+    std::vector<Token> tokens;
+    for (const std::string& line : lines)
+    {
+        std::string trimmed = trim(line);
+        if (!trimmed.empty() && trimmed[0] == '#')
+        {
+            tokens.push_back({ Token::DIRECTIVE, trimmed });
+            continue;
+        }
+        for (size_t i = 0; i < line.size();)
+        {
+            char c = line[i];
+            if (isspace((unsigned char)c))
+                i++;
+            else if (isalpha((unsigned char)c) || c == '_')
+            {
+                size_t j = i;
+                while (j < line.size() && (isalnum((unsigned char)line[j]) || line[j] == '_'))
+                    j++;
+                tokens.push_back({ Token::IDENTIFIER, line.substr(i, j - i) });
+                i = j;
+            }
+            else if (isdigit((unsigned char)c) || (c == '.' && i + 1 < line.size() && isdigit((unsigned char)line[i + 1])))
+            {
+                size_t j = i;
+                while (j < line.size() && (isalnum((unsigned char)line[j]) || line[j] == '.' ||
+                    ((line[j] == '+' || line[j] == '-') && (line[j - 1] == 'e' || line[j - 1] == 'E'))))
+                    j++;
+                tokens.push_back({ Token::NUMBER, line.substr(i, j - i) });
+                i = j;
+            }
+            else
+            {
+                std::string op(1, c);
+                for (const char* candidate : operators)
+                    if (line.compare(i, 2, candidate) == 0)
+                        op = candidate;
+                tokens.push_back({ Token::PUNCT, op });
+                i += op.size();
+            }
+        }
+    }
+    return tokens;
+}
+
+static bool is(const std::vector<Token>& t, size_t i, const char* text)
+{
+    return i < t.size() && t[i].kind != Token::DIRECTIVE && t[i].text == text;
+}
+
+static bool isBoolLiteral(const Token& token)
+{
+    return token.kind == Token::IDENTIFIER && (token.text == "true" || token.text == "false");
+}
+
+static bool isLiteral(const Token& token)
+{
+    return token.kind == Token::NUMBER || isBoolLiteral(token);
+}
+
+// index of the token matching the bracket at open (which must be "(", "[" or "{")
+static size_t matching(const std::vector<Token>& t, size_t open)
+{
+    const std::string openText = t[open].text;
+    const std::string closeText = openText == "(" ? ")" : (openText == "[" ? "]" : "}");
+    int depth = 0;
+    for (size_t i = open; i < t.size(); i++)
+    {
+        if (is(t, i, openText.c_str()))
+            depth++;
+        else if (is(t, i, closeText.c_str()) && --depth == 0)
+            return i;
+    }
+    return t.size();
+}
+
+// end (exclusive) of the statement starting at begin: a { } block or everything up to ';'
+static size_t statementEnd(const std::vector<Token>& t, size_t begin)
+{
+    if (is(t, begin, "{"))
+        return matching(t, begin) + 1;
+    if (is(t, begin, "if"))
+    {
+        size_t end = statementEnd(t, matching(t, begin + 1) + 1);
+        if (is(t, end, "else"))
+            end = statementEnd(t, end + 1);
+        return end;
+    }
+    int depth = 0;
+    for (size_t i = begin; i < t.size(); i++)
+    {
+        if (is(t, i, "(") || is(t, i, "["))
+            depth++;
+        else if (is(t, i, ")") || is(t, i, "]"))
+            depth--;
+        else if (depth == 0 && is(t, i, ";"))
+            return i + 1;
+    }
+    return t.size();
+}
+
+static double numberValue(const std::string& text)
+{
+    std::string digits = text;
+    while (!digits.empty() && (digits[digits.size() - 1] == 'f' || digits[digits.size() - 1] == 'F' || digits[digits.size() - 1] == 'u' || digits[digits.size() - 1] == 'U'))
+        digits.erase(digits.size() - 1);
+    return std::strtod(digits.c_str(), nullptr);
+}
+
+// a comparison / logical op may be folded when nothing around it binds tighter
+static bool looseLeft(const std::vector<Token>& t, size_t i)
+{
+    if (i == (size_t)-1)
+        return true;
+    static const char* const loose[] = { "(", ",", "=", "?", ":", "&&", "||", "return", "{", "}", ";" };
+    for (const char* text : loose)
+        if (is(t, i, text))
+            return true;
+    return false;
+}
+
+static bool looseRight(const std::vector<Token>& t, size_t i)
+{
+    static const char* const loose[] = { ")", ",", ";", "?", ":", "&&", "||" };
+    for (const char* text : loose)
+        if (is(t, i, text))
+            return true;
+    return false;
+}
+
+// one folding step; returns true if anything changed
+static bool foldOnce(std::vector<Token>& t)
+{
+    for (size_t i = 0; i < t.size(); i++)
+    {
+        // ( literal ) -> literal, unless it is a call or constructor argument list
+        if (is(t, i, "(") && i + 2 < t.size() && isLiteral(t[i + 1]) && is(t, i + 2, ")") &&
+            !(i > 0 && t[i - 1].kind == Token::IDENTIFIER && !isBoolLiteral(t[i - 1]) && t[i - 1].text != "return"))
+        {
+            t.erase(t.begin() + i + 2);
+            t.erase(t.begin() + i);
+            return true;
+        }
+        // !true / !false
+        if (is(t, i, "!") && i + 1 < t.size() && isBoolLiteral(t[i + 1]))
+        {
+            t[i + 1].text = t[i + 1].text == "true" ? "false" : "true";
+            t.erase(t.begin() + i);
+            return true;
+        }
+        // literal op literal
+        if (i + 2 < t.size() && isLiteral(t[i]) && isLiteral(t[i + 2]) && t[i + 1].kind == Token::PUNCT &&
+            looseLeft(t, i - 1) && looseRight(t, i + 3))
+        {
+            const std::string& op = t[i + 1].text;
+            bool bothBool = isBoolLiteral(t[i]) && isBoolLiteral(t[i + 2]);
+            bool bothNumber = t[i].kind == Token::NUMBER && t[i + 2].kind == Token::NUMBER;
+            int result = -1;
+            if (bothBool)
+            {
+                bool a = t[i].text == "true", b = t[i + 2].text == "true";
+                if (op == "==") result = a == b;
+                else if (op == "!=" || op == "^^") result = a != b;
+                else if (op == "&&") result = a && b;
+                else if (op == "||") result = a || b;
+            }
+            else if (bothNumber)
+            {
+                double a = numberValue(t[i].text), b = numberValue(t[i + 2].text);
+                if (op == "==") result = a == b;
+                else if (op == "!=") result = a != b;
+                else if (op == "<") result = a < b;
+                else if (op == ">") result = a > b;
+                else if (op == "<=") result = a <= b;
+                else if (op == ">=") result = a >= b;
+            }
+            if (result >= 0)
+            {
+                t[i].kind = Token::IDENTIFIER;
+                t[i].text = result ? "true" : "false";
+                t.erase(t.begin() + i + 1, t.begin() + i + 3);
+                return true;
+            }
+        }
+        // true && x -> x, false || x -> x, false && x -> false (x is side-effect free in GLSL expressions we emit)
+        if (i + 1 < t.size() && isBoolLiteral(t[i]) && (is(t, i + 1, "&&") || is(t, i + 1, "||")) && looseLeft(t, i - 1))
+        {
+            bool value = t[i].text == "true";
+            bool isAnd = t[i + 1].text == "&&";
+            if (value == isAnd)
+            {
+                t.erase(t.begin() + i, t.begin() + i + 2);
+                return true;
+            }
+        }
+        // cond ? a : b with a literal cond
+        if (isBoolLiteral(t[i]) && is(t, i + 1, "?") && looseLeft(t, i - 1))
+        {
+            int depth = 0;
+            size_t colon = t.size(), end = t.size();
+            for (size_t j = i + 2; j < t.size(); j++)
+            {
+                if (is(t, j, "(") || is(t, j, "[") || is(t, j, "?"))
+                    depth++;
+                else if (is(t, j, ")") || is(t, j, "]") || (is(t, j, ":") && depth > 0 && colon != t.size()))
+                {
+                    if (depth == 0)
+                    {
+                        end = j;
+                        break;
+                    }
+                    depth--;
+                }
+                else if (depth == 0 && is(t, j, ":") && colon == t.size())
+                    colon = j;
+                else if (depth == 0 && (is(t, j, ";") || is(t, j, ",")))
+                {
+                    end = j;
+                    break;
+                }
+            }
+            if (colon == t.size() || end == t.size())
+                continue;
+            std::vector<Token> chosen = t[i].text == "true" ? std::vector<Token>(t.begin() + i + 2, t.begin() + colon)
+                                                           : std::vector<Token>(t.begin() + colon + 1, t.begin() + end);
+            if (chosen.size() > 1)
+            {
+                chosen.insert(chosen.begin(), { Token::PUNCT, "(" });
+                chosen.push_back({ Token::PUNCT, ")" });
+            }
+            t.erase(t.begin() + i, t.begin() + end);
+            t.insert(t.begin() + i, chosen.begin(), chosen.end());
+            return true;
+        }
+        // if (literal) a else b
+        if (is(t, i, "if") && is(t, i + 1, "(") && i + 3 < t.size() && isBoolLiteral(t[i + 2]) && is(t, i + 3, ")"))
+        {
+            size_t thenBegin = i + 4, thenEnd = statementEnd(t, thenBegin);
+            size_t elseBegin = t.size(), elseEnd = thenEnd;
+            if (is(t, thenEnd, "else"))
+            {
+                elseBegin = thenEnd + 1;
+                elseEnd = statementEnd(t, elseBegin);
+            }
+            std::vector<Token> chosen;
+            if (t[i + 2].text == "true")
+                chosen.assign(t.begin() + thenBegin, t.begin() + thenEnd);
+            else if (elseBegin != t.size())
+                chosen.assign(t.begin() + elseBegin, t.begin() + elseEnd);
+            t.erase(t.begin() + i, t.begin() + elseEnd);
+            t.insert(t.begin() + i, chosen.begin(), chosen.end());
+            return true;
+        }
+    }
+    return false;
+}
+
+// replace "uniform T name;" with a constant and substitute simple literal values at every use
+static void inlineConstants(std::vector<Token>& t, const std::map<std::string, std::string>& constants)
+{
+    for (const std::pair<const std::string, std::string>& constant : constants)
+    {
+        std::vector<Token> value = tokenize(std::vector<std::string>(1, constant.second));
+        for (size_t i = 0; i < t.size(); i++)
+        {
+            if (is(t, i, "uniform") && i + 2 < t.size() && t[i + 2].text == constant.first)
+            {
+                // uniform T name [= default] ;  ->  const T name = value ;
+                size_t end = statementEnd(t, i);
+                std::vector<Token> declaration = { { Token::IDENTIFIER, "const" }, t[i + 1], t[i + 2], { Token::PUNCT, "=" } };
+                declaration.insert(declaration.end(), value.begin(), value.end());
+                declaration.push_back({ Token::PUNCT, ";" });
+                t.erase(t.begin() + i, t.begin() + end);
+                t.insert(t.begin() + i, declaration.begin(), declaration.end());
+                i += declaration.size() - 1;
+            }
+            else if (t[i].kind == Token::IDENTIFIER && t[i].text == constant.first && value.size() == 1 && !(i > 0 && is(t, i - 1, ".")))
+            {
+                // literal values are pasted in directly so the comparisons around them fold
+                bool declared = i >= 2 && is(t, i - 3, "const");
+                if (!declared)
+                    t[i] = value[0];
+            }
+        }
+    }
+}
+
+static size_t countUses(const std::vector<Token>& t, const std::string& name)
+{
+    size_t uses = 0;
+    for (const Token& token : t)
+        if (token.kind == Token::IDENTIFIER && token.text == name)
+            uses++;
+    return uses;
+}
+
+// remove top-level uniform/const declarations and functions that nothing references
+static bool stripUnused(std::vector<Token>& t)
+{
+    int depth = 0;
+    for (size_t i = 0; i < t.size(); i++)
+    {
+        if (is(t, i, "{"))
+            depth++;
+        else if (is(t, i, "}"))
+            depth--;
+        if (depth != 0)
+            continue;
+        bool statementStart = i == 0 || is(t, i - 1, ";") || is(t, i - 1, "}") || t[i - 1].kind == Token::DIRECTIVE;
+        if (!statementStart)
+            continue;
+
+        // uniform T name ... ;  /  const T name = ... ;
+        if ((is(t, i, "uniform") || is(t, i, "const")) && i + 2 < t.size() && t[i + 2].kind == Token::IDENTIFIER &&
+            (is(t, i + 3, ";") || is(t, i + 3, "=")) && countUses(t, t[i + 2].text) == 1)
+        {
+            t.erase(t.begin() + i, t.begin() + statementEnd(t, i));
+            return true;
+        }
+        // T name ( ... ) { ... }   with name never called
+        if (t[i].kind == Token::IDENTIFIER && i + 2 < t.size() && t[i + 1].kind == Token::IDENTIFIER && is(t, i + 2, "(") &&
+            t[i + 1].text != "main")
+        {
+            size_t close = matching(t, i + 2);
+            if (is(t, close + 1, "{") && countUses(t, t[i + 1].text) == 1)
+            {
+                t.erase(t.begin() + i, t.begin() + matching(t, close + 1) + 1);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// ------------------------------------------------------------------------
+// output
+// ------------------------------------------------------------------------
+
+// ".NAME" or ".NAME=VALUE" for the output file name; characters a path cannot hold become '_'
+static std::string variantPart(const std::string& name, const std::string& value)
+{
+    std::string part = "." + name;
+    if (!value.empty())
+    {
+        part += "=";
+        for (char c : value)
+            part += std::isalnum((unsigned char)c) || c == '.' || c == '-' || c == '+' ? c : '_';
+    }
+    return part;
+}
+
+static std::string print(const std::vector<Token>& t)
+{
+    std::string out;
+    int depth = 0, parens = 0;
+    bool lineStart = true;
+    for (size_t i = 0; i < t.size(); i++)
+    {
+        const Token& token = t[i];
+        if (token.kind == Token::DIRECTIVE)
+        {
+            if (!lineStart)
+                out += "\n";
+            out += token.text + "\n";
+            lineStart = true;
+            continue;
+        }
+        if (token.text == "}")
+            depth--;
+        if (lineStart)
+            out += std::string(depth * 4, ' ');
+        else
+        {
+            const Token& previous = t[i - 1];
+            bool tight = token.text == ")" || token.text == "]" || token.text == ";" || token.text == "," || token.text == "." ||
+                previous.text == "(" || previous.text == "[" || previous.text == "." ||
+                (token.text == "(" && previous.kind == Token::IDENTIFIER && previous.text != "if" && previous.text != "return") ||
+                token.text == "[" || token.text == "++" || token.text == "--";
+            bool unary = (previous.text == "-" || previous.text == "!") && i >= 2 &&
+                (t[i - 2].kind == Token::PUNCT && t[i - 2].text != ")" && t[i - 2].text != "]");
+            if (!tight && !unary)
+                out += " ";
+        }
+        out += token.text;
+        lineStart = false;
+
+        if (token.text == "(")
+            parens++;
+        else if (token.text == ")")
+            parens--;
+        else if (token.text == "{")
+        {
+            depth++;
+            out += "\n";
+            lineStart = true;
+        }
+        else if ((token.text == "}" && !is(t, i + 1, ";") && !(i + 2 < t.size() && t[i + 1].kind == Token::IDENTIFIER && is(t, i + 2, ";"))) ||
+            (token.text == ";" && parens == 0))
+        {
+            out += "\n";
+            lineStart = true;
+        }
+    }
+    return out;
+}
+
+struct Stats
+{
+    size_t bytes, lines, tokens, statements;
+};
+
+static Stats measure(const std::string& text)
+{
+    std::vector<Token> tokens = tokenize(splitLines(stripComments(text)));
+    Stats stats = { text.size(), 0, tokens.size(), 0 };
+    for (char c : text)
+        stats.lines += c == '\n';
+    for (const Token& token : tokens)
+        stats.statements += token.kind == Token::PUNCT && token.text == ";";
+    return stats;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cout << "usage: glsl_optimize <shader> [-D NAME[=VALUE]]... [--const UNIFORM=VALUE]..." << std::endl;
+        return 1;
+    }
+    std::string path = argv[1];
+    Preprocessor preprocessor;
+    std::map<std::string, std::string> constants;
+    std::string variantName;
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        std::string value = i + 1 < argc ? argv[i + 1] : "";
+        bool isDefine = arg == "-D", isConst = arg == "--const";
+        if (!isDefine && !isConst)
+        {
+            std::cout << "ERROR::GLSL_OPTIMIZE::UNKNOWN_ARGUMENT: " << arg << std::endl;
+            return 1;
+        }
+        i++;
+        size_t equals = value.find('=');
+        std::string name = value.substr(0, equals), content = equals == std::string::npos ? "" : value.substr(equals + 1);
+        if (isDefine)
+        {
+            preprocessor.defines[name] = content;
+            variantName += variantPart(name, content);
+        }
+        else
+            constants[name] = content;
+    }
+    // runs that differ only in a constant's value must not overwrite each other's output
+    for (const std::pair<const std::string, std::string>& constant : constants)
+        variantName += variantPart(constant.first, constant.second);
+
+    std::string original;
+    if (!readFile(path, original))
+    {
+        std::cout << "ERROR::GLSL_OPTIMIZE::FILE_NOT_SUCCESSFULLY_READ: " << path << std::endl;
+        return 1;
+    }
+    std::vector<std::string> lines;
+    if (!preprocessor.run(path, lines))
+        return 1;
+
+    std::vector<Token> tokens = tokenize(lines);
+    inlineConstants(tokens, constants);
+    while (foldOnce(tokens) || stripUnused(tokens))
+        ;
+    std::string optimized = print(tokens);
+
+    size_t dot = path.find_last_of('.');
+    size_t slash = path.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        dot = path.size();
+    std::string outputPath = path.substr(0, dot) + variantName + ".opt" + path.substr(dot);
+    std::ofstream output(outputPath, std::ios::binary | std::ios::trunc);
+    if (!output)
+    {
+        std::cout << "ERROR::GLSL_OPTIMIZE::CANNOT_WRITE: " << outputPath << std::endl;
+        return 1;
+    }
+    output << optimized;
+
+    Stats before = measure(original), after = measure(optimized);
+    std::printf("%s -> %s\n", path.c_str(), outputPath.c_str());
+    std::printf("  %-11s %8s %8s\n", "", "before", "after");
+    std::printf("  %-11s %8zu %8zu\n", "bytes", before.bytes, after.bytes);
+    std::printf("  %-11s %8zu %8zu\n", "lines", before.lines, after.lines);
+    std::printf("  %-11s %8zu %8zu\n", "tokens", before.tokens, after.tokens);
+    std::printf("  %-11s %8zu %8zu\n", "statements", before.statements, after.statements);
+    return 0;
+}
@@ -0,0 +1,340 @@
+//
+//  mesh_convert.cpp
+//  3D Object Drawing
+//
+//  Builds a binary mesh file (mesh_file.h) from an .obj / .ply model
+//  (mesh_import.h) or from geometry written as C array initializers, the way the
+//  labs keep it in source: a file with `float cube_vertices[] = { ... };` and
+//  optionally `unsigned int cube_indices[] = { ... };`.
+//  Indexed meshes are reordered for the vertex cache and fetch (mesh_optimizer.h),
+//  vertices are packed to --format and indices narrowed to the smallest type.
+//  --lods N appends up to N - 1 simplified levels (mesh_simplify.h), each aiming
+//  at half the triangles of the one before; they index the same vertices and
+//  follow LOD0 in the one index blob, described by the file's MeshLOD table,
+//  which records each level's measured distance from LOD0's surface.
+//  --meshlets splits every level into meshlets (meshlet_builder.h) for culling;
+//  each level's triangles are reordered so its meshlets are contiguous runs.
+//  Afterwards it times loading the result against parsing the text it came from.
+//
+//      mesh_convert cube.txt cube_vertices cube.mesh --indices cube_indices --format snorm16 --lods 3 --meshlets
+//      mesh_convert ../Lab5/main.cpp vertices outline.mesh --layout 2
+//      mesh_convert bunny.ply bunny.mesh --format snorm16 --lods 6 --meshlets
+//
+//  --layout lists the float components of each attribute (default 3,3: position,
+//  color); only the default layout can be packed, others are stored as floats.
+//
+
+#include "../mesh_file.h"
+#include "../mesh_import.h"
+#include "../mesh_optimizer.h"
+#include "../mesh_simplify.h"
+#include "../meshlet_builder.h"
+
+#include <cstdio>
+#include <cctype>
+#include <cstdlib>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iterator>
+#include <iostream>
+
+static bool readText(const std::string& path, std::string& text)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        return false;
+    text.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// the numbers of `name[] = { ... }` in text; "- 0.5" and "0.5f" are read as written in the labs
+// ------------------------------------------------------------------------
+static bool parseArray(const std::string& text, const std::string& name, std::vector<double>& values)
+{
+    values.clear();
+    size_t at = 0;
+    while ((at = text.find(name, at)) != std::string::npos)
+    {
+        bool wordStart = at == 0 || !(isalnum((unsigned char)text[at - 1]) || text[at - 1] == '_');
+        size_t i = at + name.size();
+        at = i;
+        if (!wordStart)
+            continue;
+        while (i < text.size() && isspace((unsigned char)text[i]))
+            i++;
+        if (text.compare(i, 1, "[") != 0)
+            continue;
+        size_t open = text.find('{', i);
+        size_t close = open == std::string::npos ? open : text.find('}', open);
+        if (close == std::string::npos)
+            return false;
+
+        for (size_t j = open + 1; j < close;)
+        {
+            char c = text[j];
+            if (c == '/' && j + 1 < close && text[j + 1] == '/')
+                j = text.find('\n', j);
+            else if (c == '/' && j + 1 < close && text[j + 1] == '*')
+                j = text.find("*/", j) + 2;
+            else if (c == '-' || c == '+' || c == '.' || isdigit((unsigned char)c))
+            {
+                double sign = 1.0;
+                if (c == '-' || c == '+')
+                {
+                    sign = c == '-' ? -1.0 : 1.0;
+                    j++;
+                    while (j < close && isspace((unsigned char)text[j]))
+                        j++;
+                }
+                char* end;
+                double value = std::strtod(text.c_str() + j, &end);
+                if (end == text.c_str() + j)
+                    return false;
+                values.push_back(sign * value);
+                j = end - text.c_str();
+                if (j < close && (text[j] == 'f' || text[j] == 'F' || text[j] == 'u' || text[j] == 'U'))
+                    j++;
+            }
+            else
+                j++;
+        }
+        return true;
+    }
+    return false;
+}
+
+static double millisecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+    std::string sourcePath = argc > 1 ? argv[1] : "";
+    std::string extension = sourcePath.substr(sourcePath.find_last_of('.') + 1);
+    // models name no arrays: <source> <output.mesh>
+    bool model = extension == "obj" || extension == "ply" || extension == "OBJ" || extension == "PLY";
+    int firstOption = model ? 3 : 4;
+    if (argc < firstOption)
+    {
+        std::cout << "usage: mesh_convert <source.obj|.ply> <output.mesh> [--format float|half|snorm16] [--lods N] [--meshlets]\n"
+                     "       mesh_convert <source> <vertex array> <output.mesh> [--indices <index array>] "
+                     "[--format float|half|snorm16] [--layout 3,3] [--lods N] [--meshlets]" << std::endl;
+        return 1;
+    }
+    std::string vertexArray = model ? "" : argv[2], outputPath = argv[firstOption - 1], indexArray;
+    VertexFormat format = VERTEX_FLOAT;
+    std::vector<uint32_t> layout = { 3, 3 };
+    int lodLevels = 1;
+    bool meshlets = false;
+    for (int i = firstOption; i < argc; i++)
+    {
+        std::string option = argv[i];
+        if (option == "--meshlets")
+        {
+            meshlets = true;
+            continue;
+        }
+        // every other option takes a value
+        std::string value = i + 1 < argc ? argv[++i] : "";
+        if (option == "--indices")
+            indexArray = value;
+        else if (option == "--format")
+            format = value == "half" ? VERTEX_HALF : value == "snorm16" ? VERTEX_SNORM16 : VERTEX_FLOAT;
+        else if (option == "--lods")
+            lodLevels = std::max(1, std::atoi(value.c_str()));
+        else if (option == "--layout")
+        {
+            layout.clear();
+            for (size_t at = 0; at < value.size(); at = value.find(',', at) == std::string::npos ? value.size() : value.find(',', at) + 1)
+                layout.push_back((uint32_t)std::atoi(value.c_str() + at));
+        }
+        else
+        {
+            std::cout << "ERROR::MESH_CONVERT::UNKNOWN_OPTION: " << option << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<double> vertexValues, indexValues;
+    ImportedMesh imported;
+    if (model)
+    {
+        if (!importMesh(sourcePath, imported))
+            return 1;
+        std::cout << "imported " << imported.fileBytes / 1e6 << " MB in " << imported.seconds * 1000.0 << " ms ("
+                  << imported.megabytesPerSecond() << " MB/s on " << imported.threads << " threads), "
+                  << imported.mergedVertices << " duplicate vertices merged, "
+                  << imported.droppedTriangles << " degenerate triangles dropped" << std::endl;
+        layout = { 3, 3 };
+    }
+    else
+    {
+        std::string text;
+        if (!readText(sourcePath, text))
+        {
+            std::cout << "ERROR::MESH_CONVERT::FILE_NOT_SUCCESSFULLY_READ: " << sourcePath << std::endl;
+            return 1;
+        }
+        if (!parseArray(text, vertexArray, vertexValues) || (!indexArray.empty() && !parseArray(text, indexArray, indexValues)))
+        {
+            std::cout << "ERROR::MESH_CONVERT::ARRAY_NOT_FOUND: " << (vertexValues.empty() ? vertexArray : indexArray) << std::endl;
+            return 1;
+        }
+    }
+
+    size_t floatsPerVertex = 0;
+    for (uint32_t components : layout)
+        floatsPerVertex += components;
+    bool positionColor = layout.size() == 2 && layout[0] == 3 && layout[1] == 3;
+    if (format != VERTEX_FLOAT && !positionColor)
+    {
+        std::cout << "ERROR::MESH_CONVERT::ONLY_3,3_CAN_BE_PACKED, storing floats" << std::endl;
+        format = VERTEX_FLOAT;
+    }
+    if (!model && (floatsPerVertex == 0 || vertexValues.size() % floatsPerVertex != 0))
+    {
+        std::cout << "ERROR::MESH_CONVERT::LAYOUT_DOES_NOT_DIVIDE_ARRAY: " << vertexValues.size() << " floats" << std::endl;
+        return 1;
+    }
+    std::vector<float> vertices(vertexValues.begin(), vertexValues.end());
+    std::vector<unsigned int> indices(indexValues.begin(), indexValues.end());
+    if (model)
+    {
+        vertices.swap(imported.vertices);
+        indices.swap(imported.indices);
+    }
+    size_t vertexCount = vertices.size() / floatsPerVertex;
+    for (unsigned int index : indices)
+        if (index >= vertexCount)
+        {
+            std::cout << "ERROR::MESH_CONVERT::INDEX_OUT_OF_RANGE: " << index << std::endl;
+            return 1;
+        }
+
+    if ((lodLevels > 1 || meshlets) && (indices.empty() || layout[0] < 3))
+    {
+        std::cout << "ERROR::MESH_CONVERT::LODS_AND_MESHLETS_NEED_INDEXED_3D_POSITIONS, writing LOD0 only" << std::endl;
+        lodLevels = 1;
+        meshlets = false;
+    }
+
+    MeshData mesh;
+    mesh.lods.push_back({ 0, (uint32_t)indices.size(), 0.0f, 0, 0 });
+    if (!indices.empty())
+    {
+        float before = acmr(indices.data(), indices.size(), vertexCount);
+        optimizeVertexCache(indices.data(), indices.size(), vertexCount);
+
+        std::vector<unsigned int> level(indices), coarser;
+        while ((int)mesh.lods.size() < lodLevels)
+        {
+            float error;
+            coarser.resize(level.size());
+            coarser.resize(simplifyMesh(coarser.data(), level.data(), level.size(), vertices.data(), vertexCount,
+                floatsPerVertex * sizeof(float), level.size() / 6 * 3, FLT_MAX, error));
+            // stop once halving no longer gets anywhere
+            if (coarser.empty() || coarser.size() > level.size() * 9 / 10)
+                break;
+            optimizeVertexCache(coarser.data(), coarser.size(), vertexCount);
+            // the simplifier's cost only ranks collapses; the table gets the measured distance to LOD0
+            error = meshDistance(indices.data(), mesh.lods[0].indexCount, coarser.data(), coarser.size(),
+                vertices.data(), floatsPerVertex * sizeof(float));
+            mesh.lods.push_back({ (uint32_t)indices.size(), (uint32_t)coarser.size(), error, 0, 0 });
+            indices.insert(indices.end(), coarser.begin(), coarser.end());
+            level.swap(coarser);
+        }
+
+        for (size_t lod = 0; meshlets && lod < mesh.lods.size(); lod++)
+        {
+            MeshLOD& range = mesh.lods[lod];
+            range.firstMeshlet = (uint32_t)mesh.meshlets.size();
+            range.meshletCount = (uint32_t)buildMeshlets(mesh.meshlets, indices.data() + range.firstIndex, range.indexCount,
+                vertices.data(), vertexCount, floatsPerVertex * sizeof(float));
+            for (size_t m = range.firstMeshlet; m < mesh.meshlets.size(); m++)
+                mesh.meshlets[m].firstIndex += range.firstIndex;
+        }
+        float after = acmr(indices.data(), mesh.lods[0].indexCount, vertexCount);
+
+        // LOD0 comes first, so the vertices follow its order and the coarser levels reuse them
+        vertexCount = optimizeVertexFetch(vertices.data(), floatsPerVertex * sizeof(float), vertexCount, indices.data(), indices.size());
+        vertices.resize(vertexCount * floatsPerVertex);
+        std::cout << "ACMR " << before << " -> " << after << std::endl;
+        for (size_t lod = 1; lod < mesh.lods.size(); lod++)
+            std::cout << "LOD" << lod << ": " << mesh.lods[lod].indexCount / 3 << " triangles, error "
+                      << mesh.lods[lod].error << std::endl;
+        for (size_t lod = 0; meshlets && lod < mesh.lods.size(); lod++)
+            std::cout << "LOD" << lod << ": " << mesh.lods[lod].meshletCount << " meshlets" << std::endl;
+    }
+    for (size_t v = 0; v < vertexCount; v++)
+        for (uint32_t axis = 0; axis < 3 && axis < layout[0]; axis++)
+        {
+            float coordinate = vertices[v * floatsPerVertex + axis];
+            mesh.boundsMin[axis] = v == 0 ? coordinate : std::min(mesh.boundsMin[axis], coordinate);
+            mesh.boundsMax[axis] = v == 0 ? coordinate : std::max(mesh.boundsMax[axis], coordinate);
+        }
+
+    mesh.format = format;
+    mesh.vertexCount = (uint32_t)vertexCount;
+    if (positionColor)
+    {
+        mesh.position = packVertices(vertices.data(), vertexCount, format, mesh.vertices);
+        mesh.vertexStride = vertexSize(format);
+        mesh.attributes = vertexFormatLayout(format);
+    }
+    else
+    {
+        mesh.vertices.assign((const unsigned char*)vertices.data(), (const unsigned char*)(vertices.data() + vertices.size()));
+        mesh.vertexStride = (uint32_t)(floatsPerVertex * sizeof(float));
+        uint32_t offset = 0;
+        for (uint32_t location = 0; location < layout.size(); location++)
+        {
+            mesh.attributes.push_back({ location, layout[location], GL_FLOAT, GL_FALSE, offset });
+            offset += layout[location] * sizeof(float);
+        }
+    }
+    mesh.indexType = smallestIndexType(vertexCount);
+    mesh.indexCount = (uint32_t)indices.size();
+    narrowIndices(indices.data(), indices.size(), mesh.indexType, mesh.indices);
+
+    if (!writeMeshFile(outputPath, mesh))
+        return 1;
+    std::cout << outputPath << ": " << vertexCount << " vertices x " << mesh.vertexStride << " B, "
+              << indices.size() << " indices x " << indexSize(mesh.indexType) << " B" << std::endl;
+
+    // load time: reading and parsing the text vs mapping and validating the binary file
+    const int RUNS = model ? 3 : 100;
+    auto start = std::chrono::steady_clock::now();
+    size_t parsed = 0;
+    for (int run = 0; run < RUNS; run++)
+    {
+        if (model)
+        {
+            ImportedMesh again;
+            importMesh(sourcePath, again);
+            parsed += again.vertices.size();
+            continue;
+        }
+        std::string source;
+        std::vector<double> values;
+        readText(sourcePath, source);
+        parseArray(source, vertexArray, values);
+        parsed += values.size();
+        if (!indexArray.empty())
+            parseArray(source, indexArray, values);
+    }
+    double textMilliseconds = millisecondsSince(start) / RUNS;
+    start = std::chrono::steady_clock::now();
+    size_t mapped = 0;
+    for (int run = 0; run < RUNS; run++)
+    {
+        MeshFile file(outputPath);
+        mapped += file.isValid() ? file.header().vertexCount : 0;
+    }
+    double binaryMilliseconds = millisecondsSince(start) / RUNS;
+    std::cout << "load: text " << textMilliseconds << " ms, mesh file " << binaryMilliseconds << " ms ("
+              << textMilliseconds / binaryMilliseconds << "x)" << std::endl;
+    return parsed > 0 && mapped > 0 ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+//
+//  uniform.h
+//  3D Object Drawing
+//
+//  Typed uniform handles. A Uniform<T> is resolved once against a Shader's
+//  reflected uniform table and set() goes straight to the matching glUniform*
+//  call: no name lookup, no std::string temporaries, no heap allocation.
+//  Values equal to the last one sent are dropped by the Shader's shadow copy.
+//  Handles re-resolve by themselves when the Shader's program is replaced
+//  (hot reload).
+//
+//      Uniform<glm::mat4> model(ourShader, "model");
+//      model.set(modelMatrix);
+//
+
+#ifndef UNIFORM_H
+#define UNIFORM_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "shader.h"
+
+#include <iostream>
+
+// maps a C++ type to its GLSL type and glUniform* call; unsupported types do not compile
+template<typename T>
+struct UniformType;
+
+template<>
+struct UniformType<bool>
+{
+    static bool accepts(GLenum type) { return type == GL_BOOL; }
+    static void upload(GLint location, bool value) { glUniform1i(location, (int)value); }
+};
+
+template<>
+struct UniformType<int>
+{
+    // samplers are set through int uniforms as well
+    static bool accepts(GLenum type) { return type == GL_INT || type == GL_BOOL || (type >= GL_SAMPLER_1D && type <= GL_SAMPLER_2D_SHADOW) || type == GL_SAMPLER_2D_RECT || type == GL_SAMPLER_BUFFER; }
+    static void upload(GLint location, int value) { glUniform1i(location, value); }
+};
+
+template<>
+struct UniformType<float>
+{
+    static bool accepts(GLenum type) { return type == GL_FLOAT; }
+    static void upload(GLint location, float value) { glUniform1f(location, value); }
+};
+
+template<>
+struct UniformType<glm::vec2>
+{
+    static bool accepts(GLenum type) { return type == GL_FLOAT_VEC2; }
+    static void upload(GLint location, const glm::vec2& value) { glUniform2fv(location, 1, &value[0]); }
+};
+
+template<>
+struct UniformType<glm::vec3>
+{
+    static bool accepts(GLenum type) { return type == GL_FLOAT_VEC3; }
+    static void upload(GLint location, const glm::vec3& value) { glUniform3fv(location, 1, &value[0]); }
+};
+
+template<>
+struct UniformType<glm::vec4>
+{
+    static bool accepts(GLenum type) { return type == GL_FLOAT_VEC4; }
+    static void upload(GLint location, const glm::vec4& value) { glUniform4fv(location, 1, &value[0]); }
+};
+
+template<>
+struct UniformType<glm::mat2>
+{
+    static bool accepts(GLenum type) { return type == GL_FLOAT_MAT2; }
+    static void upload(GLint location, const glm::mat2& value) { glUniformMatrix2fv(location, 1, GL_FALSE, &value[0][0]); }
+};
+
+template<>
+struct UniformType<glm::mat3>
+{
+    static bool accepts(GLenum type) { return type == GL_FLOAT_MAT3; }
+    static void upload(GLint location, const glm::mat3& value) { glUniformMatrix3fv(location, 1, GL_FALSE, &value[0][0]); }
+};
+
+template<>
+struct UniformType<glm::mat4>
+{
+    static bool accepts(GLenum type) { return type == GL_FLOAT_MAT4; }
+    static void upload(GLint location, const glm::mat4& value) { glUniformMatrix4fv(location, 1, GL_FALSE, &value[0][0]); }
+};
+
+template<typename T>
+class Uniform
+{
+public:
+    Uniform() : shader(nullptr), name(nullptr), location(-1), program(0) {}
+
+    // uniformName must outlive the handle (a string literal in practice)
+    Uniform(const Shader& owner, const char* uniformName) : shader(&owner), name(uniformName), location(-1), program(0)
+    {
+        resolve();
+    }
+
+    // the program must be current (shader.use()), as with the Shader::set* helpers
+    // ------------------------------------------------------------------------
+    void set(const T& value) const
+    {
+        if (shader->ID != program)
+            resolve();
+        if (shader->updateShadow(location, &value, sizeof(T)))
+            UniformType<T>::upload(location, value);
+    }
+
+    GLint getLocation() const
+    {
+        if (shader && shader->ID != program)
+            resolve();
+        return location;
+    }
+
+    bool isActive() const
+    {
+        return getLocation() >= 0;
+    }
+
+private:
+    const Shader* shader;
+    const char* name;
+    mutable GLint location;
+    mutable unsigned int program;
+
+    void resolve() const
+    {
+        program = shader->ID;
+        location = shader->uniformLocation(name);
+        GLenum type = shader->uniformType(name);
+        if (location >= 0 && !UniformType<T>::accepts(type))
+        {
+            std::cout << "ERROR::UNIFORM::TYPE_MISMATCH: " << name << std::endl;
+            location = -1;
+        }
+    }
+};
+#endif
@@ -1,16 +1,46 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aColor;
+#ifdef INSTANCED
+// per-instance attributes streamed by InstanceBatch (see instance_batch.h)
+layout (location = 2) in vec4 aInstanceColor;
+layout (location = 3) in mat4 aInstanceModel;
+#endif
 
 out vec4 color;
 
+// shared by every program, updated once per frame (see frame_data.h)
+layout (std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 cameraPosition;
+    float time;
+};
 
+#ifndef INSTANCED
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#endif
+
+#ifdef PACKED_POSITION
+// aPos is in [-1, 1] over the mesh bounds (see vertex_format.h)
+uniform vec3 positionScale;
+uniform vec3 positionBias;
+#endif
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0f);
+#ifdef PACKED_POSITION
+    vec3 position = aPos * positionScale + positionBias;
+#else
+    vec3 position = aPos;
+#endif
+#ifdef INSTANCED
+    gl_Position = viewProjection * aInstanceModel * vec4(position, 1.0f);
+    color = aInstanceColor;
+#else
+    gl_Position = viewProjection * model * vec4(position, 1.0f);
     color = vec4(aColor, 1.0f);
+#endif
 }
\ No newline at end of file
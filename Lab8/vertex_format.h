@@ -0,0 +1,130 @@
+//
+//  vertex_format.h
+//  3D Object Drawing
+//
+//  Vertex layouts for the labs' position + color meshes. The source data is
+//  always interleaved float pos[3], color[3] (24 bytes); the packed layouts
+//  convert it at upload time to 12 bytes per vertex:
+//   - VERTEX_HALF:    half-float xyzw position + unorm8 RGBA color
+//   - VERTEX_SNORM16: snorm16 xyzw position + unorm8 RGBA color
+//  Packed positions are stored relative to the mesh bounds, in [-1, 1];
+//  vertexShader.vs built with vertexFormatDefines() undoes that with the
+//  mesh's positionScale / positionBias uniforms.
+//
+
+#ifndef VERTEX_FORMAT_H
+#define VERTEX_FORMAT_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstring>
+#include <cstdint>
+
+enum VertexFormat
+{
+    VERTEX_FLOAT,
+    VERTEX_HALF,
+    VERTEX_SNORM16
+};
+
+// world position = stored position * scale + bias; identity for VERTEX_FLOAT
+struct PositionTransform
+{
+    glm::vec3 scale = glm::vec3(1.0f);
+    glm::vec3 bias = glm::vec3(0.0f);
+};
+
+// one packed vertex as it sits in the buffer
+struct PackedVertex
+{
+    uint16_t position[4];
+    uint32_t color;
+};
+static_assert(sizeof(PackedVertex) == 12, "packed vertices are 12 bytes");
+
+// bytes per vertex in the buffer
+inline GLsizei vertexSize(VertexFormat format)
+{
+    return format == VERTEX_FLOAT ? 6 * sizeof(float) : sizeof(PackedVertex);
+}
+
+// bytes per index of GL_UNSIGNED_BYTE / SHORT / INT
+inline size_t indexSize(GLenum type)
+{
+    return type == GL_UNSIGNED_BYTE ? 1 : type == GL_UNSIGNED_SHORT ? 2 : 4;
+}
+
+// shader defines selecting the matching position decode in vertexShader.vs
+inline std::vector<std::string> vertexFormatDefines(VertexFormat format)
+{
+    if (format == VERTEX_FLOAT)
+        return std::vector<std::string>();
+    return std::vector<std::string>(1, "PACKED_POSITION");
+}
+
+// convert count interleaved pos[3] + color[3] float vertices into format, replacing out
+// ------------------------------------------------------------------------
+inline PositionTransform packVertices(const float* vertices, size_t count, VertexFormat format, std::vector<unsigned char>& out)
+{
+    PositionTransform transform;
+    if (format == VERTEX_FLOAT)
+    {
+        out.assign((const unsigned char*)vertices, (const unsigned char*)(vertices + count * 6));
+        return transform;
+    }
+
+    // map the bounding box onto [-1, 1]^3 so the 16 bits cover just the mesh
+    glm::vec3 low(0.0f), high(0.0f);
+    for (size_t i = 0; i < count; i++)
+    {
+        glm::vec3 position(vertices[i * 6], vertices[i * 6 + 1], vertices[i * 6 + 2]);
+        low = i == 0 ? position : glm::min(low, position);
+        high = i == 0 ? position : glm::max(high, position);
+    }
+    transform.bias = (low + high) * 0.5f;
+    transform.scale = (high - low) * 0.5f;
+    for (int axis = 0; axis < 3; axis++)
+        if (transform.scale[axis] <= 0.0f)
+            transform.scale[axis] = 1.0f;
+
+    out.resize(count * sizeof(PackedVertex));
+    for (size_t i = 0; i < count; i++)
+    {
+        const float* v = vertices + i * 6;
+        glm::vec4 position(((glm::vec3(v[0], v[1], v[2]) - transform.bias) / transform.scale), 1.0f);
+        PackedVertex packed;
+        uint64_t bits = format == VERTEX_HALF ? glm::packHalf4x16(position) : glm::packSnorm4x16(position);
+        std::memcpy(packed.position, &bits, sizeof(packed.position));
+        packed.color = glm::packUnorm4x8(glm::vec4(v[3], v[4], v[5], 1.0f));
+        std::memcpy(&out[i * sizeof(PackedVertex)], &packed, sizeof(PackedVertex));
+    }
+    return transform;
+}
+
+// attribute 0 (position) and 1 (color) for the bound VAO, reading from the bound GL_ARRAY_BUFFER
+// ------------------------------------------------------------------------
+inline void vertexFormatAttributes(VertexFormat format)
+{
+    if (format == VERTEX_FLOAT)
+    {
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+    }
+    else
+    {
+        // the shader reads vec3 aPos; w is only there to keep the color 4-byte aligned
+        if (format == VERTEX_HALF)
+            glVertexAttribPointer(0, 4, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex), (void*)0);
+        else // 3.3 decodes snorm as (2c + 1) / 65535, off by at most 1.5e-5 of the half extent
+            glVertexAttribPointer(0, 4, GL_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)0);
+        glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, color));
+    }
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+}
+#endif